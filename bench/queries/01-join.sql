@@ -0,0 +1 @@
+select F.id, D.tag from F, D where F.did = D.id;
@@ -0,0 +1 @@
+select F.id, C.label from F, D, C, E where F.did = D.id and D.cid = C.id and E.fid = F.id;
@@ -0,0 +1 @@
+select E.id, F.val from E, F where E.fid = F.id;
@@ -0,0 +1 @@
+select distinct F.gid from F;
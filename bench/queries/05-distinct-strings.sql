@@ -0,0 +1 @@
+select distinct F.name from F;
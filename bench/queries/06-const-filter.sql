@@ -0,0 +1 @@
+select F.id, F.name from F where F.val = 7;
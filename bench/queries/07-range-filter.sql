@@ -0,0 +1 @@
+select F.id, F.val from F where F.val < 100 and F.did > 5000;
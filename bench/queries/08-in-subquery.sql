@@ -0,0 +1 @@
+select F.id from F where F.did in (select D.id from D where D.cid < 10;);
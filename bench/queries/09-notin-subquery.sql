@@ -0,0 +1 @@
+select E.id from E where E.fid notin (select F.id from F where F.val < 500;);
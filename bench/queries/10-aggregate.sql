@@ -0,0 +1 @@
+select F.did, min(F.val), min(F.name) from F groupby F.did;
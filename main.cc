@@ -1,15 +1,59 @@
+#include <cstring>
 #include <stdexcept>
+#include <string>
 #include "parser/query.h"
 #include "planner/constructor.h"
+#include "operators/arena.h"
+#include "operators/explain.h"
+#include "operators/gather.h"
 #include "operators/print.h"
+#include "operators/sort.h"
+#include "operators/threadpool.h"
 
 using namespace ToyDBMS;
 
-int main(){
+// usage: testexe [-j THREADS] [--unordered] [--sort-memory MB]
+// -j runs the query on the given number of threads, --unordered lets
+// a parallel query return rows in any order, --sort-memory sets the memory
+// an ORDER BY sorts in before it spills to temporary files.
+int main(int argc, char **argv){
     try {
+        size_t threads = 1;
+        bool ordered = true;
+        for(int i = 1; i < argc; i++){
+            if(std::strcmp(argv[i], "-j") == 0 && i + 1 < argc){
+                threads = std::stoul(argv[++i]);
+            } else if(std::strcmp(argv[i], "--unordered") == 0){
+                ordered = false;
+            } else if(std::strcmp(argv[i], "--sort-memory") == 0 && i + 1 < argc){
+                Sort::configureMemory(std::stoul(argv[++i]) << 20);
+            } else throw std::runtime_error(std::string("unknown argument ") + argv[i]);
+        }
+        ThreadPool::configure(threads);
+
     	std::cout.sync_with_stdio(false);
-        Print p {ConstructedQuery(Query::parse(std::cin)).takeOperator()};
-        while(p.next());
+
+        // declared before the operators, so everything they allocate from it outlives them
+        Arena arena;
+        Arena::Scope scope(arena);
+
+        Query query = Query::parse(std::cin);
+        std::unique_ptr<Operator> root = ConstructedQuery(query).takeOperator();
+        if(threads > 1)
+            root = std::make_unique<Gather>(std::move(root), ordered);
+
+        if(query.explain == Query::Explain::PLAN){
+            explain(*root, std::cout);
+            return 0;
+        }
+
+        if(query.explain == Query::Explain::ANALYZE){
+            explain_analyze(std::move(root), std::cout);
+            return 0;
+        }
+
+        Print p {std::move(root)};
+        while(!p.nextBatch().empty());
         return 0;
     } catch(std::exception &e){
         std::cerr << e.what();
@@ -14,5 +14,7 @@ namespace ToyDBMS {
 			const Header &header() override { return *header_ptr; }
 			Row next() override { return {}; }
 			void reset() override {}
+
+			std::string describe() override { return "EmptyOperator"; }
 	};
 }
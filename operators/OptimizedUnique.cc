@@ -3,6 +3,31 @@
 #include "OptimizedUnique.h"
 
 namespace ToyDBMS {
+	template<typename Column>
+	bool OptimizedUnique::isNew(const Column &column) {
+		// the ordered values of the first row start the first group
+		if (attributeValue.size() < indicesOfOrdered.size()) {
+			for (int index : indicesOfOrdered) {
+				attributeValue.push_back(column(index));
+			}
+		} else {
+			bool hasChanged = false;
+			for (int i = 0; i < indicesOfOrdered.size(); ++i) {
+				const Value &currentValue = column(indicesOfOrdered[i]);
+				if (attributeValue[i] != currentValue) {
+					attributeValue[i] = currentValue;
+					hasChanged = true;
+				}
+			}
+
+			if (hasChanged) {
+				hashTable.clear();
+			}
+		}
+
+		return hashTable.insert([&](size_t i) -> const Value & { return column(indicesOfNotOrdered[i]); });
+	}
+
 	Row OptimizedUnique::next() {
 		while (true) {
 			Row r = child->next();
@@ -10,40 +35,30 @@ namespace ToyDBMS {
 				return {};
 			}
 
-			if (hashTable.size() > 0) {
-				bool hasChanged = false;
-				for (int i = 0; i < orderedAttributes.size(); ++i) {
-					Value currentValue = r[orderedAttributes[i]];
+			if (isNew([&r](size_t index) -> const Value & { return r.values[index]; })) {
+				return r;
+			}
+		}
+	}
 
-					if (attributeValue.size() < orderedAttributes.size()) {
-						attributeValue.push_back(currentValue);
-					} else {
-						if (attributeValue[i] != currentValue) {
-							attributeValue[i] = currentValue;
-							hasChanged = true;
-						}
-					}
-				}
+	Batch OptimizedUnique::nextBatch() {
+		while (true) {
+			Batch batch = child->nextBatch();
+			if (batch.empty()) {
+				return batch;
+			}
 
-				if (hasChanged) {
-					hashTable.clear();
+			size_t kept = 0;
+			for (uint32_t position : batch.selection) {
+				if (isNew([&](size_t index) -> const Value & { return batch.columns[index][position]; })) {
+					batch.selection[kept++] = position;
 				}
 			}
+			batch.selection.resize(kept);
 
-			std::vector<Value> compressed = compress(r);
-			if (hashTable.find(compressed) == hashTable.end()) {
-				hashTable.insert(compressed);
-				return r;
+			if (!batch.empty()) {
+				return batch;
 			}
 		}
 	}
-
-	std::vector<Value> OptimizedUnique::compress(const Row &row) {
-		std::vector<Value> result;
-		for (int index : indicesOfNotOrdered) {
-			result.push_back(row.values[index]);
-		}
-
-		return std::move(result);
-	}
 }
@@ -1,15 +1,19 @@
 #pragma once
+#include "distinctset.h"
 #include "operator.h"
 #include "../parser/query.h"
 
-#include <unordered_set>
+#include <algorithm>
 
 namespace ToyDBMS {
 	class OptimizedUnique : public Operator {
 		std::unique_ptr<Operator> child;
-		std::unordered_set<std::vector<Value>> hashTable;
+
+		// the values that are not ordered of the distinct rows of the current group
+		DistinctSet hashTable;
 
 		const std::vector<std::string> orderedAttributes;
+		std::vector<int> indicesOfOrdered;
 		std::vector<int> indicesOfNotOrdered;
 
 		std::vector<Value> attributeValue;
@@ -18,22 +22,29 @@ namespace ToyDBMS {
 			OptimizedUnique(
 				std::unique_ptr<Operator> child,
 				const std::vector<std::string> &orderedAttributes
-			) : child(std::move(child)), orderedAttributes(orderedAttributes) {
-				std::unordered_set<int> indicesOfOrdered;
+			) : child(std::move(child)), hashTable(0), orderedAttributes(orderedAttributes) {
 				for (const std::string &attribute : orderedAttributes) {
-					indicesOfOrdered.insert(this->child->header().index(attribute));
+					indicesOfOrdered.push_back(this->child->header().index(attribute));
 				}
 
 				for (int i = 0; i < this->child->header().size(); ++i) {
-					if (indicesOfOrdered.find(i) == indicesOfOrdered.end()) {
+					if (std::find(indicesOfOrdered.begin(), indicesOfOrdered.end(), i) == indicesOfOrdered.end()) {
 						indicesOfNotOrdered.push_back(i);
 					}
 				}
+
+				hashTable = DistinctSet(indicesOfNotOrdered.size());
 			}
 
 			const Header &header() { return child->header(); }
 
 			Row next() override;
+			Batch nextBatch() override;
+
+			std::string describe() override { return "OptimizedUnique, sorted on " + attribute_list(orderedAttributes); }
+			std::vector<std::unique_ptr<Operator> *> inputs() override { return {&child}; }
+
+			size_t memoryUsage() override { return hashTable.memoryUsage(); }
 
 			void reset() override {
 				child->reset();
@@ -42,6 +53,9 @@ namespace ToyDBMS {
 			}
 
 		private:
-			std::vector<Value> compress(const Row &row);
+			// Starts a new group if the ordered values differ from those of
+			// the group before, then adds the other values to the group.
+			template<typename Column>
+			bool isNew(const Column &column);
 	};
 }
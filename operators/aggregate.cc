@@ -0,0 +1,221 @@
+#include <algorithm>
+#include "aggregate.h"
+
+namespace ToyDBMS {
+
+uint32_t GroupTable::findOrInsert(const std::vector<Value> &values, const std::vector<Header::size_type> &indices){
+	std::hash<Value> hasher;
+	size_t hash = 0;
+	for(Header::size_type index : indices)
+		hash ^= hasher(values[index]) + 0x9e3779b9 + (hash<<6) + (hash>>2);
+
+	size_t mask = slots.size() - 1;
+	for(size_t i = hash & mask; ; i = (i + 1) & mask){
+		Slot &slot = slots[i];
+		if(slot.group == EMPTY) break;
+		if(slot.hash != hash) continue;
+
+		const Value *stored = key(slot.group);
+		bool equal = true;
+		for(size_t k = 0; k < width && equal; k++)
+			equal = stored[k] == values[indices[k]];
+		if(equal) return slot.group;
+	}
+
+	uint32_t group = groups++;
+	for(Header::size_type index : indices)
+		keys.push_back(values[index]);
+
+	// the table is kept at most half full so probe sequences stay short
+	if(2 * groups > slots.size())
+		grow();
+
+	mask = slots.size() - 1;
+	size_t i = hash & mask;
+	while(slots[i].group != EMPTY)
+		i = (i + 1) & mask;
+	slots[i] = Slot {hash, group};
+
+	return group;
+}
+
+void GroupTable::grow(){
+	std::vector<Slot> old(2 * slots.size(), Slot {0, EMPTY});
+	old.swap(slots);
+
+	size_t mask = slots.size() - 1;
+	for(const Slot &slot : old){
+		if(slot.group == EMPTY) continue;
+		size_t i = slot.hash & mask;
+		while(slots[i].group != EMPTY)
+			i = (i + 1) & mask;
+		slots[i] = slot;
+	}
+}
+
+void GroupTable::clear(){
+	std::fill(slots.begin(), slots.end(), Slot {0, EMPTY});
+	keys.clear();
+	groups = 0;
+}
+
+static Header construct_header(const std::vector<std::string> &groupBy, const std::vector<Aggregate> &aggregates){
+	Header header(groupBy.begin(), groupBy.end());
+	for(const Aggregate &aggregate : aggregates)
+		header.push_back(aggregate.name());
+	return header;
+}
+
+AbstractAggregate::AbstractAggregate(
+	std::unique_ptr<Operator> child,
+	const std::vector<std::string> &groupBy,
+	const std::vector<Aggregate> &aggregates
+) : child(std::move(child)),
+	header_ptr(std::make_shared<Header>(construct_header(groupBy, aggregates))),
+	aggregates(aggregates),
+	groups(groupBy.size()) {
+	for(const std::string &attribute : groupBy)
+		keyIndices.push_back(this->child->header().index(attribute));
+
+	for(const Aggregate &aggregate : aggregates){
+		aggregateIndices.push_back(
+			aggregate.function == Aggregate::Function::COUNT ? 0 : this->child->header().index(aggregate.attribute)
+		);
+	}
+}
+
+std::string AbstractAggregate::aggregation() const {
+	std::vector<std::string> names;
+	for(const Aggregate &aggregate : aggregates)
+		names.push_back(aggregate.name());
+
+	std::string result = attribute_list(names);
+	if(!keyIndices.empty()){
+		Header groupBy(header_ptr->begin(), header_ptr->begin() + keyIndices.size());
+		result += " by " + attribute_list(groupBy);
+	}
+	return result;
+}
+
+void AbstractAggregate::accumulate(const Row &row){
+	size_t before = groups.size();
+	uint32_t group = groups.findOrInsert(row.values, keyIndices);
+
+	if(groups.size() != before){
+		counts.push_back(0);
+		for(size_t i = 0; i < aggregates.size(); i++){
+			bool isMinimum = aggregates[i].function == Aggregate::Function::MINIMUM;
+			minimums.push_back(isMinimum ? row.values[aggregateIndices[i]] : Value(0));
+		}
+	}
+
+	counts[group]++;
+	Value *groupMinimums = minimums.data() + group * aggregates.size();
+	for(size_t i = 0; i < aggregates.size(); i++){
+		if(aggregates[i].function != Aggregate::Function::MINIMUM) continue;
+		const Value &value = row.values[aggregateIndices[i]];
+		if(value < groupMinimums[i])
+			groupMinimums[i] = value;
+	}
+}
+
+void AbstractAggregate::readRun(){
+	groups.clear();
+	counts.clear();
+	minimums.clear();
+	emitted = 0;
+
+	if(pending){
+		endsRun(pending, 0);
+		accumulate(pending);
+		pending = {};
+	}
+
+	while(true){
+		Row row = reader->next();
+		if(!row){
+			inputDone = true;
+			break;
+		}
+
+		sawInput = true;
+		if(endsRun(row, groups.size())){
+			pending = std::move(row);
+			break;
+		}
+
+		accumulate(row);
+	}
+
+	// without GROUP BY an empty input still forms a single group,
+	// so COUNT(*) reports zero; MIN has no value to report then
+	if(!sawInput && keyIndices.empty()){
+		for(const Aggregate &aggregate : aggregates){
+			if(aggregate.function != Aggregate::Function::COUNT) return;
+		}
+
+		std::vector<Value> empty;
+		groups.findOrInsert(empty, keyIndices);
+		counts.push_back(0);
+		for(size_t i = 0; i < aggregates.size(); i++)
+			minimums.push_back(Value(0));
+	}
+}
+
+Row AbstractAggregate::next(){
+	if(!reader)
+		reader = std::make_unique<BatchReader>(*child);
+
+	while(emitted == groups.size()){
+		if(inputDone) return {};
+		readRun();
+	}
+
+	size_t group = emitted++;
+	std::vector<Value> values(groups.key(group), groups.key(group) + keyIndices.size());
+	values.reserve(header_ptr->size());
+	for(size_t i = 0; i < aggregates.size(); i++){
+		if(aggregates[i].function == Aggregate::Function::COUNT)
+			values.push_back(Value(static_cast<int>(counts[group])));
+		else
+			values.push_back(minimums[group * aggregates.size() + i]);
+	}
+
+	return Row(std::move(values));
+}
+
+void AbstractAggregate::reset(){
+	child->reset();
+	reader.reset();
+	groups.clear();
+	counts.clear();
+	minimums.clear();
+	pending = {};
+	emitted = 0;
+	inputDone = false;
+	sawInput = false;
+}
+
+std::string SortedAggregate::describe(){
+	Header ordered;
+	for(Header::size_type index : orderedIndices)
+		ordered.push_back(child->header()[index]);
+	return "SortedAggregate " + aggregation() + ", sorted on " + attribute_list(ordered);
+}
+
+bool SortedAggregate::endsRun(const Row &row, size_t groupsInRun){
+	if(groupsInRun == 0){
+		runValues.clear();
+		for(Header::size_type index : orderedIndices)
+			runValues.push_back(row.values[index]);
+		return false;
+	}
+
+	for(size_t i = 0; i < orderedIndices.size(); i++){
+		if(row.values[orderedIndices[i]] != runValues[i]) return true;
+	}
+
+	return false;
+}
+
+}
@@ -0,0 +1,148 @@
+#pragma once
+#include <cstdint>
+#include <memory>
+#include "operator.h"
+
+namespace ToyDBMS {
+	struct Aggregate {
+		enum class Function { COUNT, MINIMUM };
+
+		Function function;
+		std::string attribute; // empty for COUNT(*)
+
+		Aggregate(Function function, std::string attribute = "")
+			: function(function), attribute(std::move(attribute)) {}
+
+		// name of the output column, e.g. "COUNT(*)" or "MIN(A.id)"
+		std::string name() const {
+			return function == Function::COUNT ? "COUNT(*)" : "MIN(" + attribute + ")";
+		}
+	};
+
+	// Maps group keys to dense group numbers. Keys are stored contiguously,
+	// slots hold a precomputed hash and a group number and are probed linearly.
+	class GroupTable {
+		struct Slot {
+			size_t hash;
+			uint32_t group;
+		};
+
+		static constexpr uint32_t EMPTY = UINT32_MAX;
+
+		size_t width;
+		std::vector<Slot> slots;
+		std::vector<Value> keys;
+		size_t groups = 0;
+
+		public:
+			GroupTable(size_t width) : width(width), slots(16, Slot {0, EMPTY}) {}
+
+			size_t size() const { return groups; }
+
+			const Value *key(size_t group) const { return keys.data() + group * width; }
+
+			// Returns the group of the key made of values[indices[i]], creating it if needed.
+			uint32_t findOrInsert(const std::vector<Value> &values, const std::vector<Header::size_type> &indices);
+
+			void clear();
+
+			size_t memoryUsage() const { return slots.capacity() * sizeof(Slot) + keys.capacity() * sizeof(Value); }
+
+		private:
+			void grow();
+	};
+
+	// Groups the input by the group-by attributes and computes the aggregates
+	// for every group. Output rows consist of the group-by attributes followed by
+	// the aggregates, groups are emitted in the order they first appear.
+	// The input is consumed in runs: all groups of a run are emitted once the run ends.
+	class AbstractAggregate : public Operator {
+		protected:
+			std::unique_ptr<Operator> child;
+
+		private:
+			std::shared_ptr<Header> header_ptr;
+			std::vector<Header::size_type> keyIndices;
+			std::vector<Aggregate> aggregates;
+			std::vector<Header::size_type> aggregateIndices;
+
+			std::unique_ptr<BatchReader> reader;
+			GroupTable groups;
+			std::vector<int64_t> counts;
+			std::vector<Value> minimums;
+
+			Row pending;
+			size_t emitted = 0;
+			bool inputDone = false;
+			bool sawInput = false;
+
+		public:
+			AbstractAggregate(
+				std::unique_ptr<Operator> child,
+				const std::vector<std::string> &groupBy,
+				const std::vector<Aggregate> &aggregates
+			);
+
+			const Header &header() override { return *header_ptr; }
+			Row next() override;
+			void reset() override;
+
+			std::vector<std::unique_ptr<Operator> *> inputs() override { return {&child}; }
+
+			size_t memoryUsage() override {
+				return groups.memoryUsage() + counts.capacity() * sizeof(int64_t) + minimums.capacity() * sizeof(Value);
+			}
+
+		protected:
+			// The aggregates and the group-by attributes, for describe().
+			std::string aggregation() const;
+
+			// Tells whether the row belongs to a new run. Called for every input row,
+			// groupsInRun is zero for the first row of a run.
+			virtual bool endsRun(const Row &row, size_t groupsInRun) = 0;
+
+		private:
+			void readRun();
+			void accumulate(const Row &row);
+	};
+
+	// Aggregates the whole input in a single hash table.
+	class HashAggregate : public AbstractAggregate {
+		public:
+			HashAggregate(
+				std::unique_ptr<Operator> child,
+				const std::vector<std::string> &groupBy,
+				const std::vector<Aggregate> &aggregates
+			) : AbstractAggregate(std::move(child), groupBy, aggregates) {}
+
+			std::string describe() override { return "HashAggregate " + aggregation(); }
+
+		protected:
+			bool endsRun(const Row &row, size_t groupsInRun) override { return false; }
+	};
+
+	// Aggregates an input that is sorted on some of the group-by attributes:
+	// a run ends whenever those attributes change, so only the groups of the
+	// current run are kept in memory.
+	class SortedAggregate : public AbstractAggregate {
+		std::vector<Header::size_type> orderedIndices;
+		std::vector<Value> runValues;
+
+		public:
+			SortedAggregate(
+				std::unique_ptr<Operator> child,
+				const std::vector<std::string> &groupBy,
+				const std::vector<Aggregate> &aggregates,
+				const std::vector<std::string> &orderedAttributes
+			) : AbstractAggregate(std::move(child), groupBy, aggregates) {
+				for (const std::string &attribute : orderedAttributes) {
+					orderedIndices.push_back(this->child->header().index(attribute));
+				}
+			}
+
+			std::string describe() override;
+
+		protected:
+			bool endsRun(const Row &row, size_t groupsInRun) override;
+	};
+}
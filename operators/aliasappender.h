@@ -6,6 +6,7 @@ namespace ToyDBMS {
 	class AliasAppender : public Operator {
 		private:
 			std::unique_ptr<Operator> child;
+			std::string alias;
 			std::shared_ptr<Header> header_ptr;
 
 			Header construct_header(const Header &h, const std::string &alias) {
@@ -22,10 +23,32 @@ namespace ToyDBMS {
 		public:
 			AliasAppender(std::unique_ptr<Operator> child, const std::string &alias)
 				: child(std::move(child)),
+				  alias(alias),
 				  header_ptr(std::make_shared<Header>(construct_header(this->child->header(), alias))) {}
 
 			const Header &header() override { return *header_ptr; }
 			Row next() override { return child->next(); }
+			Batch nextBatch() override { return child->nextBatch(); }
 			void reset() override { child->reset(); }
+
+			std::vector<std::unique_ptr<Operator>> split(size_t parts) override {
+				std::vector<std::unique_ptr<Operator>> result = child->split(parts);
+				for (auto &part : result) {
+					part = std::make_unique<AliasAppender>(std::move(part), alias);
+				}
+
+				return result;
+			}
+
+			bool pushRuntimeFilter(const std::string &attribute, std::shared_ptr<const RuntimeFilter> filter) override {
+				if (attribute.compare(0, alias.size() + 1, alias + ".") != 0) {
+					return false;
+				}
+
+				return child->pushRuntimeFilter(attribute.substr(alias.size() + 1), std::move(filter));
+			}
+
+			std::string describe() override { return "AliasAppender " + alias; }
+			std::vector<std::unique_ptr<Operator> *> inputs() override { return {&child}; }
 	};
 }
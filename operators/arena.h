@@ -0,0 +1,261 @@
+#pragma once
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <new>
+#include <string>
+#include <unordered_set>
+#include <vector>
+
+namespace ToyDBMS {
+
+class Arena;
+
+// A string stored in an arena, its characters follow the header.
+struct InternedString {
+    const char *data;
+    size_t size;
+};
+
+// Strings that don't fit into a Value. Every distinct string is stored once
+// in the arena of the pool, so equal strings have equal addresses. Shards
+// with their own locks let parallel scans intern concurrently.
+class StringPool {
+    static constexpr size_t SHARDS = 64;
+
+    struct Hash {
+        // eight bytes at a time, without copying the characters
+        size_t operator()(const InternedString *s) const {
+            uint64_t h = s->size * 0x9e3779b97f4a7c15ULL;
+            size_t i = 0;
+            for(; i + 8 <= s->size; i += 8){
+                uint64_t word;
+                std::memcpy(&word, s->data + i, sizeof(word));
+                h = (h ^ word) * 0xff51afd7ed558ccdULL;
+                h ^= h >> 32;
+            }
+            for(; i < s->size; i++)
+                h = (h ^ static_cast<unsigned char>(s->data[i])) * 0x100000001b3ULL;
+            return static_cast<size_t>(h ^ (h >> 29));
+        }
+    };
+
+    struct Equal {
+        bool operator()(const InternedString *a, const InternedString *b) const {
+            return a->size == b->size && std::memcmp(a->data, b->data, a->size) == 0;
+        }
+    };
+
+    struct Shard {
+        std::mutex mutex;
+        std::unordered_set<const InternedString *, Hash, Equal> strings;
+    };
+
+    Arena &arena;
+    Shard shards[SHARDS];
+
+public:
+    explicit StringPool(Arena &arena): arena(arena) {}
+
+    const InternedString *intern(const char *begin, const char *end);
+
+    // forgets all the strings, their memory belongs to the arena
+    void clear(){
+        for(Shard &shard : shards){
+            std::lock_guard<std::mutex> lock(shard.mutex);
+            shard.strings.clear();
+        }
+    }
+};
+
+// Bump allocator for the memory that lives as long as a query: materialized
+// rows, hash table nodes and interned strings. Small allocations are never
+// freed one by one; reset() recycles all the chunks at once and the destructor
+// releases them. Every thread bumps through a block of its own, so concurrent
+// operators only synchronize when they need a new block. Large allocations,
+// such as the buffers of growing vectors, come from the heap and go back to
+// it when they are released.
+class Arena {
+    static constexpr size_t CHUNK_SIZE = size_t(1) << 20;
+    static constexpr size_t LARGE_SIZE = CHUNK_SIZE / 8;
+
+    struct ThreadBlock {
+        uint64_t generation = 0;
+        char *current = nullptr;
+        char *end = nullptr;
+    };
+
+    std::mutex mutex;
+    std::vector<std::unique_ptr<char[]>> chunks;
+    std::vector<std::unique_ptr<char[]>> free_chunks;
+    std::unordered_set<void *> large;
+
+    // identifies the blocks handed out since the last reset, unique across arenas
+    std::atomic<uint64_t> generation;
+
+    StringPool string_pool {*this};
+
+    static uint64_t nextGeneration(){
+        static std::atomic<uint64_t> counter {0};
+        return ++counter;
+    }
+
+    static ThreadBlock &threadBlock(){
+        static thread_local ThreadBlock block;
+        return block;
+    }
+
+    static Arena *&scoped(){
+        static Arena *arena = nullptr;
+        return arena;
+    }
+
+    char *newChunk(){
+        std::lock_guard<std::mutex> lock(mutex);
+        if(free_chunks.empty()){
+            chunks.emplace_back(new char[CHUNK_SIZE]);
+        } else {
+            chunks.push_back(std::move(free_chunks.back()));
+            free_chunks.pop_back();
+        }
+        return chunks.back().get();
+    }
+
+    void freeLarge(){
+        for(void *memory : large)
+            ::operator delete(memory);
+        large.clear();
+    }
+
+public:
+    Arena(): generation(nextGeneration()) {}
+    ~Arena(){ freeLarge(); }
+
+    Arena(const Arena &) = delete;
+    Arena &operator=(const Arena &) = delete;
+
+    // alignment can't be larger than the one of operator new
+    void *allocate(size_t size, size_t alignment){
+        if(size > LARGE_SIZE){
+            void *memory = ::operator new(size);
+            std::lock_guard<std::mutex> lock(mutex);
+            large.insert(memory);
+            return memory;
+        }
+
+        ThreadBlock &block = threadBlock();
+        uint64_t current_generation = generation.load(std::memory_order_relaxed);
+        while(true){
+            if(block.generation == current_generation){
+                uintptr_t position = reinterpret_cast<uintptr_t>(block.current);
+                uintptr_t aligned = (position + alignment - 1) / alignment * alignment;
+                if(aligned + size <= reinterpret_cast<uintptr_t>(block.end)){
+                    block.current = reinterpret_cast<char *>(aligned + size);
+                    return block.current - size;
+                }
+            }
+
+            block.current = newChunk();
+            block.end = block.current + CHUNK_SIZE;
+            block.generation = current_generation;
+        }
+    }
+
+    // Only large allocations are given back, the others stay until reset().
+    void release(void *memory, size_t size){
+        if(size <= LARGE_SIZE) return;
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            large.erase(memory);
+        }
+        ::operator delete(memory);
+    }
+
+    const InternedString *intern(const char *begin, const char *end){
+        return string_pool.intern(begin, end);
+    }
+
+    // Makes all the memory reusable. Nothing allocated before may be used
+    // afterwards, and no other thread may allocate meanwhile.
+    void reset(){
+        string_pool.clear();
+        std::lock_guard<std::mutex> lock(mutex);
+        for(auto &chunk : chunks)
+            free_chunks.push_back(std::move(chunk));
+        chunks.clear();
+        freeLarge();
+        generation = nextGeneration();
+    }
+
+    // The arena of the running query, or one that lives as long as the
+    // process when no query has set its own.
+    static Arena &current(){
+        if(Arena *arena = scoped()) return *arena;
+        static Arena *process = new Arena();
+        return *process;
+    }
+
+    // Makes an arena current for all threads while the scope is alive. Only
+    // to be created and destroyed while no query is running.
+    class Scope {
+        Arena *previous;
+    public:
+        explicit Scope(Arena &arena): previous(scoped()) { scoped() = &arena; }
+        ~Scope(){ scoped() = previous; }
+
+        Scope(const Scope &) = delete;
+        Scope &operator=(const Scope &) = delete;
+    };
+};
+
+inline const InternedString *StringPool::intern(const char *begin, const char *end){
+    InternedString key {begin, static_cast<size_t>(end - begin)};
+    Shard &shard = shards[Hash()(&key) % SHARDS];
+    std::lock_guard<std::mutex> lock(shard.mutex);
+
+    auto found = shard.strings.find(&key);
+    if(found != shard.strings.end()) return *found;
+
+    void *memory = arena.allocate(sizeof(InternedString) + key.size, alignof(InternedString));
+    InternedString *stored = static_cast<InternedString *>(memory);
+    char *chars = reinterpret_cast<char *>(stored + 1);
+    std::memcpy(chars, begin, key.size);
+    stored->data = chars;
+    stored->size = key.size;
+    shard.strings.insert(stored);
+    return stored;
+}
+
+// Standard allocator interface over an arena, for containers that are built
+// once and live as long as the query. The arena is the current one when the
+// allocator is created.
+template<typename T>
+struct ArenaAllocator {
+    using value_type = T;
+
+    Arena *arena;
+
+    ArenaAllocator(): arena(&Arena::current()) {}
+    explicit ArenaAllocator(Arena &arena): arena(&arena) {}
+    template<typename U>
+    ArenaAllocator(const ArenaAllocator<U> &other): arena(other.arena) {}
+
+    T *allocate(size_t n){
+        return static_cast<T *>(arena->allocate(n * sizeof(T), alignof(T)));
+    }
+
+    void deallocate(T *memory, size_t n){
+        arena->release(memory, n * sizeof(T));
+    }
+
+    template<typename U>
+    bool operator==(const ArenaAllocator<U> &other) const { return arena == other.arena; }
+    template<typename U>
+    bool operator!=(const ArenaAllocator<U> &other) const { return arena != other.arena; }
+};
+
+}
@@ -0,0 +1,53 @@
+#pragma once
+#include <cstdint>
+#include <memory>
+#include <vector>
+#include "row.h"
+
+namespace ToyDBMS {
+
+// A chunk of tuples stored column by column. Only the positions listed in
+// `selection` are live: operators that drop tuples shrink the selection
+// instead of moving column data around.
+struct Batch {
+    static constexpr size_t CAPACITY = 1024;
+
+    std::vector<std::vector<Value>> columns;
+    std::vector<uint32_t> selection;
+
+    Batch(){}
+    explicit Batch(size_t width): columns(width) {
+        for(auto &column : columns) column.reserve(CAPACITY);
+        selection.reserve(CAPACITY);
+    }
+
+    // number of live tuples
+    size_t size() const { return selection.size(); }
+    bool empty() const { return selection.empty(); }
+
+    // number of stored tuples, live or not
+    size_t length() const { return stored; }
+    bool full() const { return stored >= CAPACITY; }
+
+    void append(std::vector<Value> &&values){
+        for(size_t i = 0; i < columns.size(); i++)
+            columns[i].push_back(std::move(values[i]));
+        selection.push_back(stored++);
+    }
+
+    // marks the tuple that was just written column by column as stored and live
+    void commit(){ selection.push_back(stored++); }
+
+    std::vector<Value> values(uint32_t position) const {
+        std::vector<Value> result;
+        result.reserve(columns.size());
+        for(const auto &column : columns)
+            result.push_back(column[position]);
+        return result;
+    }
+
+private:
+    size_t stored = 0;
+};
+
+}
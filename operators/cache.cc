@@ -1,20 +1,65 @@
 #include <algorithm>
 #include <iterator>
 #include "cache.h"
+#include "threadpool.h"
 
 namespace ToyDBMS {
+	static void append_rows(Operator &input, std::vector<Value, ArenaAllocator<Value>> &values) {
+		BatchReader reader(input);
+		for (Row row = reader.next(); row; row = reader.next()) {
+			values.insert(values.end(), row.values.begin(), row.values.end());
+		}
+	}
+
+	Cache::Cache(std::unique_ptr<Operator> child)
+	: child(std::move(child)), width(this->child->header().size()) {}
+
+	// With several threads the parts of the split input are read concurrently
+	// and concatenated in input order.
+	void Cache::fill() {
+		filled = true;
+
+		std::vector<std::unique_ptr<Operator>> parts;
+		if (ThreadPool::threads() > 1) {
+			parts = child->split(ThreadPool::morsels());
+		}
+
+		if (parts.empty()) {
+			append_rows(*child, cached);
+		} else {
+			std::vector<std::vector<Value, ArenaAllocator<Value>>> partValues(parts.size());
+			parallel_for(parts.size(), [&](size_t i) {
+				append_rows(*parts[i], partValues[i]);
+			});
+
+			size_t total = 0;
+			for (const auto &values : partValues) {
+				total += values.size();
+			}
+
+			cached.reserve(total);
+			for (const auto &values : partValues) {
+				cached.insert(cached.end(), values.begin(), values.end());
+			}
+		}
+	}
+
 	Row Cache::next() {
-		if (iterator == cached.end()){
+		if (!filled) {
+			fill();
+		}
+
+		if (position == cached.size()) {
 			return {};
 		}
 
-		Row result = *iterator;
-		iterator++;
+		auto begin = cached.begin() + position;
+		position += width;
 
-		return result;
+		return Row(std::vector<Value>(begin, begin + width));
 	}
 
 	void Cache::reset() {
-		iterator = cached.begin();
+		position = 0;
 	}
 }
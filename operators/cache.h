@@ -1,32 +1,36 @@
 #pragma once
+#include "arena.h"
 #include "operator.h"
 #include "../parser/query.h"
 
 #include <unordered_set>
 
 namespace ToyDBMS {
+	// Materializes its input when it is first read. The rows are stored one
+	// after another in a single vector in the query's arena.
 	class Cache : public Operator {
 		std::unique_ptr<Operator> child;
 
-		std::vector<Row> cached;
-		std::vector<Row>::iterator iterator;
+		size_t width;
+		std::vector<Value, ArenaAllocator<Value>> cached;
+		size_t position = 0;
+		bool filled = false;
 
 		public:
-			Cache(std::unique_ptr<Operator> child)
-			: child(std::move(child)) {
-				Row current_row = this->child->next();
-				while (current_row) {
-					cached.push_back(current_row);
-					current_row = this->child->next();
-				}
-
-				iterator = cached.begin();
-			}
+			Cache(std::unique_ptr<Operator> child);
 
 			const Header &header() { return child->header(); }
 
 			Row next() override;
 
 			void reset() override;
+
+		private:
+			void fill();
+
+		public:
+			std::string describe() override { return "Cache"; }
+			std::vector<std::unique_ptr<Operator> *> inputs() override { return {&child}; }
+			size_t memoryUsage() override { return cached.capacity() * sizeof(Value); }
 	};
 }
@@ -0,0 +1,35 @@
+#pragma once
+#include <cstdint>
+
+// On-disk columnar table format (native byte order), one file per table:
+//
+//   ColumnarFileHeader
+//   ColumnarColumn[columns]
+//   column names, then one segment per column, every segment 8-byte aligned
+//
+// An INT column segment is an array of `rows` int32 values. A STR column
+// segment is an array of `rows + 1` uint64 offsets into the column blob,
+// followed by the blob itself; value i is blob[offsets[i], offsets[i + 1]).
+// All offsets in the descriptors are relative to the beginning of the file.
+
+namespace ToyDBMS {
+
+struct ColumnarFileHeader {
+    static constexpr char MAGIC[8] = {'T', 'O', 'Y', 'D', 'B', 'C', 'O', 'L'};
+
+    char magic[8];
+    uint64_t rows;
+    uint64_t columns;
+};
+
+struct ColumnarColumn {
+    enum Type : uint32_t { INT = 0, STR = 1 };
+
+    uint32_t type;
+    uint32_t name_length;
+    uint64_t name_offset;
+    uint64_t data_offset;
+    uint64_t blob_offset;
+};
+
+}
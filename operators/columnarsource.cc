@@ -0,0 +1,187 @@
+#include <algorithm>
+#include <cstring>
+#include <stdexcept>
+#include "columnarsource.h"
+
+namespace ToyDBMS {
+
+constexpr char ColumnarFileHeader::MAGIC[8];
+
+ColumnarSource::ColumnarSource(std::string filename){
+    std::size_t dot_pos = filename.rfind('.');
+    std::size_t sep_pos = filename.find_last_of("/\\");
+
+    if(dot_pos == std::string::npos || sep_pos == std::string::npos || dot_pos < sep_pos)
+        throw std::runtime_error("invalid filename: " + filename);
+
+    std::string table_name = filename.substr(sep_pos + 1, dot_pos - sep_pos);
+
+    file = std::make_shared<MappedFile>(filename);
+    const char *data = file->begin();
+
+    auto check_range = [&](uint64_t offset, uint64_t size){
+        if(offset > file->size() || size > file->size() - offset)
+            throw std::runtime_error("corrupted columnar file: " + filename);
+    };
+
+    check_range(0, sizeof(ColumnarFileHeader));
+    const auto *file_header = reinterpret_cast<const ColumnarFileHeader *>(data);
+    if(std::memcmp(file_header->magic, ColumnarFileHeader::MAGIC, sizeof(file_header->magic)) != 0)
+        throw std::runtime_error("not a columnar table: " + filename);
+
+    rows = file_header->rows;
+    check_range(sizeof(ColumnarFileHeader), file_header->columns * sizeof(ColumnarColumn));
+    const auto *descriptors = reinterpret_cast<const ColumnarColumn *>(data + sizeof(ColumnarFileHeader));
+
+    header_ptr = std::make_shared<Header>();
+    for(uint64_t i = 0; i < file_header->columns; i++){
+        const ColumnarColumn &descriptor = descriptors[i];
+        check_range(descriptor.name_offset, descriptor.name_length);
+        header_ptr->push_back(table_name + std::string(data + descriptor.name_offset, descriptor.name_length));
+
+        ColumnSegment segment {};
+        switch(descriptor.type){
+        case ColumnarColumn::INT:
+            check_range(descriptor.data_offset, rows * sizeof(int32_t));
+            segment.type = Value::Type::INT;
+            segment.ints = reinterpret_cast<const int32_t *>(data + descriptor.data_offset);
+            break;
+        case ColumnarColumn::STR:
+            check_range(descriptor.data_offset, (rows + 1) * sizeof(uint64_t));
+            segment.type = Value::Type::STR;
+            segment.offsets = reinterpret_cast<const uint64_t *>(data + descriptor.data_offset);
+            check_range(descriptor.blob_offset, segment.offsets[rows]);
+            segment.blob = data + descriptor.blob_offset;
+            break;
+        default:
+            throw std::runtime_error("unknown column type in " + filename);
+        }
+        columns.push_back(segment);
+    }
+}
+
+ColumnarSource::ColumnarSource(std::string filename, const std::unordered_set<std::string> &attributes)
+    : ColumnarSource(std::move(filename)) {
+    std::vector<ColumnSegment> selected;
+    auto header = std::make_shared<Header>();
+    for(size_t i = 0; i < columns.size(); i++){
+        if(attributes.count((*header_ptr)[i])){
+            selected.push_back(columns[i]);
+            header->push_back((*header_ptr)[i]);
+        }
+    }
+    if(selected.empty() && !columns.empty()){
+        selected.push_back(columns.front());
+        header->push_back(header_ptr->front());
+    }
+
+    columns = std::move(selected);
+    header_ptr = std::move(header);
+}
+
+Value ColumnarSource::value(const ColumnSegment &column, uint64_t row){
+    switch(column.type){
+    case Value::Type::INT:
+        return Value(static_cast<int>(column.ints[row]));
+    case Value::Type::STR:
+        return Value(column.blob + column.offsets[row], column.blob + column.offsets[row + 1]);
+    default:
+        throw std::runtime_error("unknown value type");
+    }
+}
+
+bool ColumnarSource::passesRuntimeFilters(uint64_t row) const {
+    for(const auto &entry : runtime_filters){
+        if(!entry.second->mayContain(value(columns[entry.first], row))) return false;
+    }
+    return true;
+}
+
+bool ColumnarSource::pushRuntimeFilter(const std::string &attribute, std::shared_ptr<const RuntimeFilter> filter){
+    auto it = std::find(header_ptr->begin(), header_ptr->end(), attribute);
+    if(it == header_ptr->end()) return false;
+
+    runtime_filters.emplace_back(it - header_ptr->begin(), std::move(filter));
+    return true;
+}
+
+std::string ColumnarSource::describe(){
+    std::string result = "ColumnarSource " + attribute_list(*header_ptr);
+    for(const auto &filter : runtime_filters)
+        result += ", runtime filter on " + (*header_ptr)[filter.first];
+    return result;
+}
+
+Row ColumnarSource::next(){
+    while(current < rows && !runtime_filters.empty() && !passesRuntimeFilters(current))
+        current++;
+    if(current >= rows) return {};
+
+    std::vector<Value> values;
+    values.reserve(columns.size());
+
+    for(const ColumnSegment &column : columns)
+        values.push_back(value(column, current));
+
+    current++;
+    return Row(std::move(values));
+}
+
+Batch ColumnarSource::nextBatch(){
+    Batch batch(columns.size());
+
+    if(!runtime_filters.empty()){
+        // the key columns are checked first, the other columns are read for the passing rows only
+        std::vector<uint64_t> passing;
+        for(; current < rows && passing.size() < Batch::CAPACITY; current++){
+            if(passesRuntimeFilters(current))
+                passing.push_back(current);
+        }
+
+        for(size_t i = 0; i < columns.size(); i++){
+            for(uint64_t row : passing)
+                batch.columns[i].push_back(value(columns[i], row));
+        }
+
+        for(size_t i = 0; i < passing.size(); i++)
+            batch.commit();
+
+        return batch;
+    }
+
+    uint64_t batch_end = std::min<uint64_t>(rows, current + Batch::CAPACITY);
+
+    for(size_t i = 0; i < columns.size(); i++){
+        const ColumnSegment &column = columns[i];
+        std::vector<Value> &output = batch.columns[i];
+        for(uint64_t row = current; row < batch_end; row++){
+            switch(column.type){
+            case Value::Type::INT:
+                output.emplace_back(static_cast<int>(column.ints[row]));
+                break;
+            case Value::Type::STR:
+                output.emplace_back(column.blob + column.offsets[row], column.blob + column.offsets[row + 1]);
+                break;
+            }
+        }
+    }
+
+    for(; current < batch_end; current++)
+        batch.commit();
+
+    return batch;
+}
+
+std::vector<std::unique_ptr<Operator>> ColumnarSource::split(size_t parts){
+    std::vector<std::unique_ptr<Operator>> result;
+    uint64_t count = rows - current;
+    for(size_t i = 0; i < parts; i++){
+        uint64_t begin = current + count * i / parts;
+        uint64_t end = current + count * (i + 1) / parts;
+        if(begin < end)
+            result.emplace_back(new ColumnarSource(*this, begin, end));
+    }
+    return result;
+}
+
+}
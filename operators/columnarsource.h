@@ -0,0 +1,57 @@
+#pragma once
+#include <memory>
+#include <string>
+#include <unordered_set>
+
+#include "operator.h"
+#include "mappedfile.h"
+#include "columnar.h"
+#include "runtimefilter.h"
+
+namespace ToyDBMS {
+
+// Scans a table stored in the columnar format described in columnar.h.
+// Values are read straight from the mapped column segments. With runtime
+// filters only the rows whose key columns pass them are materialized.
+class ColumnarSource : public Operator {
+    struct ColumnSegment {
+        Value::Type type;
+        const int32_t *ints;
+        const uint64_t *offsets;
+        const char *blob;
+    };
+
+    std::shared_ptr<MappedFile> file;
+    uint64_t first = 0;   // rows [first, rows) are scanned
+    uint64_t rows = 0;
+    uint64_t current = 0;
+    std::vector<ColumnSegment> columns;
+    std::shared_ptr<Header> header_ptr;
+
+    // runtime filters by the index of the column they check
+    std::vector<std::pair<size_t, std::shared_ptr<const RuntimeFilter>>> runtime_filters;
+public:
+    ColumnarSource(std::string filename);
+
+    // Reads only the given attributes, or the first one if the table has none of them.
+    ColumnarSource(std::string filename, const std::unordered_set<std::string> &attributes);
+
+    const Header &header() override { return *header_ptr; }
+    Row next() override;
+    Batch nextBatch() override;
+    void reset() override { current = first; }
+    std::vector<std::unique_ptr<Operator>> split(size_t parts) override;
+    bool pushRuntimeFilter(const std::string &attribute, std::shared_ptr<const RuntimeFilter> filter) override;
+    std::string describe() override;
+
+private:
+    ColumnarSource(const ColumnarSource &source, uint64_t first, uint64_t end)
+        : file(source.file), first(first), rows(end), current(first),
+          columns(source.columns), header_ptr(source.header_ptr),
+          runtime_filters(source.runtime_filters) {}
+
+    static Value value(const ColumnSegment &column, uint64_t row);
+    bool passesRuntimeFilters(uint64_t row) const;
+};
+
+}
@@ -0,0 +1,29 @@
+#pragma once
+#include <memory>
+#include "operator.h"
+
+namespace ToyDBMS {
+	// Produces a single row known at planning time.
+	class ConstantRow : public Operator {
+		private:
+			std::shared_ptr<Header> header_ptr;
+			std::vector<Value> values;
+			bool emitted = false;
+
+		public:
+			ConstantRow(const Header &header, std::vector<Value> values)
+				: header_ptr(std::make_shared<Header>(header)), values(std::move(values)) {}
+
+			const Header &header() override { return *header_ptr; }
+
+			Row next() override {
+				if(emitted) return {};
+				emitted = true;
+				return Row(std::vector<Value>(values));
+			}
+
+			void reset() override { emitted = false; }
+
+			std::string describe() override { return "ConstantRow"; }
+	};
+}
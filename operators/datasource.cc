@@ -1,14 +1,34 @@
 #include <algorithm>
-#include <sstream>
+#include <cstring>
 #include <stdexcept>
 #include "datasource.h"
 
 namespace ToyDBMS {
 
-DataSource::DataSource(std::string filename): file(filename) {
-    if(!file.good())
-        throw std::runtime_error("failed to open file: " + filename);
+static const char *find_char(const char *begin, const char *end, char c){
+    const void *found = std::memchr(begin, c, end - begin);
+    return found ? static_cast<const char *>(found) : end;
+}
+
+static int parse_int(const char *begin, const char *end){
+    const char *p = begin;
+    bool negative = false;
+    if(p != end && (*p == '-' || *p == '+')){
+        negative = *p == '-';
+        p++;
+    }
+
+    if(p == end || *p < '0' || *p > '9')
+        throw std::runtime_error("invalid integer value: " + std::string(begin, end));
+
+    int result = 0;
+    for(; p != end && *p >= '0' && *p <= '9'; p++)
+        result = result * 10 + (*p - '0');
+
+    return negative ? -result : result;
+}
 
+DataSource::DataSource(std::string filename){
     std::size_t dot_pos = filename.rfind('.');
     std::size_t sep_pos = filename.find_last_of("/\\");
 
@@ -17,46 +37,168 @@ DataSource::DataSource(std::string filename): file(filename) {
 
     std::string table_name = filename.substr(sep_pos + 1, dot_pos - sep_pos);
 
-    std::string header_line;
-    std::getline(file, header_line);
+    file = std::make_shared<MappedFile>(filename);
+    const char *data = file->begin();
+    end = file->end();
+
+    const char *header_end = data ? find_char(data, end, '\n') : end;
 
     header_ptr = std::make_shared<Header>();
 
-    std::istringstream ss {header_line};
-    std::string part;
-    while(std::getline(ss, part, ',')){
+    const char *part = data;
+    while(part < header_end){
+        const char *part_end = find_char(part, header_end, ',');
         std::string attr = table_name;
-        attr.append(part.begin() + 2, part.end());
-        file_header.emplace_back(attr, part[0] == 'i' ? Value::Type::INT : Value::Type::STR);
+        attr.append(std::min(part + 2, part_end), part_end);
+        file_header.emplace_back(attr, *part == 'i' ? Value::Type::INT : Value::Type::STR);
+        fields.push_back(fields.size());
         header_ptr->push_back(std::move(attr));
+        if(part_end == header_end) break;
+        part = part_end + 1;
     }
 
-    after_header = file.tellg();
+    after_header = header_end < end ? header_end + 1 : end;
+    current = after_header;
 }
 
-Row DataSource::next(){
-    std::string line, part;
-    if(!std::getline(file, line)) return {};
-    std::istringstream ss {line};
+DataSource::DataSource(std::string filename, const std::unordered_set<std::string> &attributes)
+    : DataSource(std::move(filename)) {
+    std::vector<size_t> selected;
+    for(size_t field : fields){
+        if(attributes.count(file_header[field].first))
+            selected.push_back(field);
+    }
+    if(selected.empty() && !fields.empty())
+        selected.push_back(fields.front());
 
-    std::vector<Value> values;
-    for(auto &field : file_header){
-        std::getline(ss, part, ',');
-        switch(field.second){
+    fields = std::move(selected);
+    header_ptr = std::make_shared<Header>();
+    for(size_t field : fields)
+        header_ptr->push_back(file_header[field].first);
+}
+
+DataSource::DataSource(const DataSource &source, const char *begin, const char *end)
+    : file(source.file), after_header(begin), current(begin), end(end),
+      file_header(source.file_header), fields(source.fields), header_ptr(source.header_ptr),
+      runtime_filters(source.runtime_filters) {}
+
+bool DataSource::pushRuntimeFilter(const std::string &attribute, std::shared_ptr<const RuntimeFilter> filter){
+    auto it = std::find(header_ptr->begin(), header_ptr->end(), attribute);
+    if(it == header_ptr->end()) return false;
+
+    std::pair<size_t, std::shared_ptr<const RuntimeFilter>> entry(fields[it - header_ptr->begin()], std::move(filter));
+    runtime_filters.insert(
+        std::upper_bound(runtime_filters.begin(), runtime_filters.end(), entry,
+            [](const auto &a, const auto &b){ return a.first < b.first; }),
+        std::move(entry)
+    );
+    return true;
+}
+
+std::string DataSource::describe(){
+    std::string result = "DataSource " + attribute_list(*header_ptr);
+    for(const auto &filter : runtime_filters)
+        result += ", runtime filter on " + file_header[filter.first].first;
+    return result;
+}
+
+bool DataSource::passesRuntimeFilters(const char *begin, const char *end) const {
+    const char *field = begin;
+    size_t index = 0;
+    for(const auto &entry : runtime_filters){
+        for(; index < entry.first; index++){
+            const char *field_end = find_char(field, end, ',');
+            field = field_end < end ? field_end + 1 : end;
+        }
+
+        const char *field_end = find_char(field, end, ',');
+        bool passes = file_header[index].second == Value::Type::INT
+            ? entry.second->mayContain(Value(parse_int(field, field_end)))
+            : entry.second->mayContain(Value(field, field_end));
+        if(!passes) return false;
+    }
+    return true;
+}
+
+std::vector<std::unique_ptr<Operator>> DataSource::split(size_t parts){
+    std::vector<std::unique_ptr<Operator>> result;
+    size_t length = end - current;
+    const char *begin = current;
+
+    for(size_t i = 1; i <= parts && begin < end; i++){
+        // every range ends right after a line break
+        const char *range_end = i == parts ? end : current + length * i / parts;
+        if(range_end > begin && range_end < end && range_end[-1] != '\n'){
+            range_end = find_char(range_end, end, '\n');
+            if(range_end < end) range_end++;
+        }
+
+        if(range_end <= begin) continue;
+        result.emplace_back(new DataSource(*this, begin, range_end));
+        begin = range_end;
+    }
+
+    return result;
+}
+
+template<typename Output>
+bool DataSource::readLine(Output output){
+    const char *line_end;
+    while(true){
+        while(current < end && *current == '\n') current++;
+        if(current >= end) return false;
+
+        line_end = find_char(current, end, '\n');
+        if(runtime_filters.empty() || passesRuntimeFilters(current, line_end)) break;
+        current = line_end < end ? line_end + 1 : end;
+    }
+
+    const char *field = current;
+    size_t index = 0;
+    for(size_t i = 0; i < fields.size(); i++){
+        // the fields that are not read are only looked through for the delimiter
+        for(; index < fields[i]; index++){
+            const char *field_end = find_char(field, line_end, ',');
+            field = field_end < line_end ? field_end + 1 : line_end;
+        }
+
+        const char *field_end = find_char(field, line_end, ',');
+        switch(file_header[index].second){
         case Value::Type::INT:
-            values.emplace_back(std::stoi(part));
+            output(i).emplace_back(parse_int(field, field_end));
             break;
         case Value::Type::STR:
-            values.emplace_back(part);
+            output(i).emplace_back(field, field_end);
             break;
         }
+        field = field_end < line_end ? field_end + 1 : line_end;
+        index++;
     }
-    return {header_ptr, std::move(values)};
+
+    current = line_end < end ? line_end + 1 : end;
+    return true;
+}
+
+Row DataSource::next(){
+    std::vector<Value> values;
+    values.reserve(fields.size());
+
+    if(!readLine([&values](size_t) -> std::vector<Value> & { return values; }))
+        return {};
+
+    return Row(std::move(values));
+}
+
+Batch DataSource::nextBatch(){
+    Batch batch(fields.size());
+    while(!batch.full() && readLine([&batch](size_t i) -> std::vector<Value> & { return batch.columns[i]; }))
+        batch.commit();
+
+    return batch;
 }
 
 void DataSource::reset(){
-    file.clear();
-    file.seekg(after_header);
+    current = after_header;
 }
 
 }
@@ -1,24 +1,58 @@
 #pragma once
 #include <memory>
-#include <fstream>
 #include <string>
+#include <unordered_set>
 
 #include "operator.h"
+#include "mappedfile.h"
+#include "runtimefilter.h"
 
 namespace ToyDBMS {
 
+// Scans a CSV table. The file is memory-mapped and tokenized in place,
+// so reading a row does not go through iostreams. A split scan reads
+// ranges of whole lines of the same mapping. A scan may read a subset of the
+// fields, the others are skipped without being parsed. Lines whose key fields
+// are rejected by a runtime filter are skipped before the other fields are parsed.
 class DataSource : public Operator {
-    std::ifstream file;
-    std::streampos after_header;
+    std::shared_ptr<MappedFile> file;
+
+    const char *after_header = nullptr;
+    const char *current = nullptr;
+    const char *end = nullptr;
                         // attr name ,  attr type
     std::vector<std::pair<std::string, Value::Type>> file_header;
+    std::vector<size_t> fields; // fields that are read, in file order
     std::shared_ptr<Header> header_ptr;
+
+    // runtime filters by the index of the field they check, in field order
+    std::vector<std::pair<size_t, std::shared_ptr<const RuntimeFilter>>> runtime_filters;
 public:
     DataSource(std::string filename);
 
+    // Reads only the given attributes, or the first one if the file has none of them.
+    DataSource(std::string filename, const std::unordered_set<std::string> &attributes);
+
     const Header &header() override { return *header_ptr; }
+    const std::vector<std::pair<std::string, Value::Type>> &fileHeader() const { return file_header; }
     Row next() override;
+    Batch nextBatch() override;
     void reset() override;
+    std::vector<std::unique_ptr<Operator>> split(size_t parts) override;
+    bool pushRuntimeFilter(const std::string &attribute, std::shared_ptr<const RuntimeFilter> filter) override;
+    std::string describe() override;
+
+private:
+    // scan of the lines in [begin, end) of the same file
+    DataSource(const DataSource &source, const char *begin, const char *end);
+
+    // Checks the fields of the line [begin, end) the runtime filters apply to.
+    bool passesRuntimeFilters(const char *begin, const char *end) const;
+
+    // Parses the next line, appending the i-th field that is read to output(i).
+    // Returns false at the end of file.
+    template<typename Output>
+    bool readLine(Output output);
 };
 
 }
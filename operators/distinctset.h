@@ -0,0 +1,139 @@
+#pragma once
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "arena.h"
+#include "row.h"
+
+namespace ToyDBMS {
+
+// A set of keys of `width` values for duplicate elimination. The keys are
+// copied one after another into pages taken from the query's arena, a key
+// that is already present is not copied at all. The table is open-addressed
+// with linear probing: a slot holds the hash of its key and where the key is
+// stored, so probing compares hashes before values and growing moves slots
+// without hashing the keys again. Values are compared by their 16 bytes,
+// which are their canonical form.
+//
+// A key is given as a function from its column to the value, so it may be
+// read straight out of a row or a batch.
+class DistinctSet {
+    static constexpr size_t MIN_SLOTS = 16;
+    static constexpr size_t PAGE_BYTES = size_t(64) << 10;
+
+    struct Slot {
+        size_t hash;
+        const Value *key; // nullptr in an empty slot
+    };
+
+    size_t width;
+    size_t stride;        // values reserved per key, at least one
+    size_t keys_per_page;
+
+    std::vector<Slot> slots;
+    size_t mask;
+    std::vector<const Value *> keys; // in insertion order
+
+    std::vector<Value *> pages;
+    size_t page = 0;       // the page keys are copied to
+    size_t page_used = 0;  // keys in it
+
+public:
+    explicit DistinctSet(size_t width)
+        : width(width), stride(width ? width : 1),
+          keys_per_page(std::max<size_t>(1, PAGE_BYTES / (stride * sizeof(Value)))),
+          slots(MIN_SLOTS, Slot{0, nullptr}), mask(MIN_SLOTS - 1) {}
+
+    size_t size() const { return keys.size(); }
+
+    // the keys in the order they were inserted
+    const Value *key(size_t i) const { return keys[i]; }
+
+    // Adds the key unless it is present, returns whether it was added.
+    template<typename Key>
+    bool insert(const Key &key){
+        size_t hash = hashOf(key);
+        size_t i = hash & mask;
+        for(; slots[i].key != nullptr; i = (i + 1) & mask){
+            if(slots[i].hash == hash && equal(slots[i].key, key)) return false;
+        }
+
+        if((keys.size() + 1) * 4 > slots.size() * 3){
+            grow();
+            for(i = hash & mask; slots[i].key != nullptr; i = (i + 1) & mask);
+        }
+
+        slots[i] = {hash, store(key)};
+        return true;
+    }
+
+    // Forgets the keys. The pages are reused, and the table keeps room for
+    // about as many keys as it held.
+    void clear(){
+        if(keys.empty()) return;
+
+        size_t capacity = MIN_SLOTS;
+        while(capacity * 3 < keys.size() * 4) capacity *= 2;
+        slots.assign(capacity, Slot{0, nullptr});
+        mask = capacity - 1;
+        keys.clear();
+        page = 0;
+        page_used = 0;
+    }
+
+    size_t memoryUsage() const {
+        return slots.capacity() * sizeof(Slot) + keys.capacity() * sizeof(const Value *)
+             + pages.size() * keys_per_page * stride * sizeof(Value);
+    }
+
+private:
+    template<typename Key>
+    size_t hashOf(const Key &key) const {
+        uint64_t h = width;
+        for(size_t i = 0; i < width; i++){
+            h = (h ^ key(i).hash()) * 0xff51afd7ed558ccdULL;
+            h ^= h >> 32;
+        }
+        return static_cast<size_t>(h);
+    }
+
+    template<typename Key>
+    bool equal(const Value *stored, const Key &key) const {
+        for(size_t i = 0; i < width; i++)
+            if(!(stored[i] == key(i))) return false;
+        return true;
+    }
+
+    template<typename Key>
+    const Value *store(const Key &key){
+        if(page_used == keys_per_page){
+            page++;
+            page_used = 0;
+        }
+        if(page == pages.size()){
+            void *memory = Arena::current().allocate(keys_per_page * stride * sizeof(Value), alignof(Value));
+            pages.push_back(static_cast<Value *>(memory));
+        }
+
+        Value *stored = pages[page] + page_used++ * stride;
+        for(size_t i = 0; i < width; i++)
+            stored[i] = key(i);
+        keys.push_back(stored);
+        return stored;
+    }
+
+    void grow(){
+        std::vector<Slot> old(slots.size() * 2, Slot{0, nullptr});
+        old.swap(slots);
+        mask = slots.size() - 1;
+        for(const Slot &slot : old){
+            if(slot.key == nullptr) continue;
+            size_t i = slot.hash & mask;
+            while(slots[i].key != nullptr) i = (i + 1) & mask;
+            slots[i] = slot;
+        }
+    }
+};
+
+}
@@ -0,0 +1,202 @@
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <iomanip>
+#include "explain.h"
+
+namespace ToyDBMS {
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+// What an operator and all of its split parts did.
+struct Counters {
+    std::atomic<uint64_t> rows {0};
+    std::atomic<uint64_t> next_calls {0};
+    std::atomic<uint64_t> batch_calls {0};
+    std::atomic<uint64_t> resets {0};
+    std::atomic<uint64_t> nanoseconds {0};
+    std::atomic<size_t> peak_memory {0};
+};
+
+// Adds the time until it is destroyed to the counters.
+class Timer {
+    Counters &counters;
+    Clock::time_point start = Clock::now();
+public:
+    explicit Timer(Counters &counters): counters(counters) {}
+    ~Timer(){
+        counters.nanoseconds += std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() - start).count();
+    }
+};
+
+// Sits in an input slot of an operator and counts the calls to the input.
+class Probe : public Operator {
+    std::unique_ptr<Operator> target;
+    std::shared_ptr<Counters> counters;
+
+    void sampleMemory(){
+        size_t bytes = target->memoryUsage();
+        size_t peak = counters->peak_memory;
+        while(bytes > peak && !counters->peak_memory.compare_exchange_weak(peak, bytes));
+    }
+
+public:
+    Probe(std::unique_ptr<Operator> target, std::shared_ptr<Counters> counters)
+        : target(std::move(target)), counters(std::move(counters)) {
+        setEstimatedRows(this->target->estimatedRows());
+    }
+
+    const Header &header() override { return target->header(); }
+
+    Row next() override {
+        Row row;
+        {
+            Timer timer(*counters);
+            row = target->next();
+        }
+        counters->next_calls++;
+        if(row) counters->rows++;
+        sampleMemory();
+        return row;
+    }
+
+    Batch nextBatch() override {
+        Batch batch;
+        {
+            Timer timer(*counters);
+            batch = target->nextBatch();
+        }
+        counters->batch_calls++;
+        counters->rows += batch.size();
+        sampleMemory();
+        return batch;
+    }
+
+    void reset() override {
+        Timer timer(*counters);
+        counters->resets++;
+        target->reset();
+    }
+
+    // A split may build the hash table of a join, which is counted as its time.
+    // A gather that has not started hands out the parts of its input, those
+    // are already counted for the input.
+    std::vector<std::unique_ptr<Operator>> split(size_t parts) override {
+        std::vector<std::unique_ptr<Operator>> result;
+        {
+            Timer timer(*counters);
+            result = target->split(parts);
+        }
+        sampleMemory();
+        for(auto &part : result){
+            if(!dynamic_cast<Probe *>(part.get()))
+                part = std::make_unique<Probe>(std::move(part), counters);
+        }
+        return result;
+    }
+
+    bool pushRuntimeFilter(const std::string &attribute, std::shared_ptr<const RuntimeFilter> filter) override {
+        return target->pushRuntimeFilter(attribute, std::move(filter));
+    }
+
+    std::string describe() override { return target->describe(); }
+    size_t memoryUsage() override { return target->memoryUsage(); }
+};
+
+struct Node {
+    Operator *op;
+    std::shared_ptr<Counters> counters;
+    std::vector<Node> inputs;
+};
+
+// Puts probes into all the input slots below the operator.
+Node instrument(Operator &op, std::shared_ptr<Counters> counters){
+    Node node {&op, std::move(counters), {}};
+    for(std::unique_ptr<Operator> *slot : op.inputs()){
+        Operator &input = **slot;
+        auto inputCounters = std::make_shared<Counters>();
+        *slot = std::make_unique<Probe>(std::move(*slot), inputCounters);
+        node.inputs.push_back(instrument(input, std::move(inputCounters)));
+    }
+    return node;
+}
+
+void print_operator(Operator &op, size_t depth, std::ostream &os){
+    os << std::string(2 * depth, ' ') << op.describe();
+    double estimate = op.estimatedRows();
+    if(estimate >= 0)
+        os << "  (estimated rows: " << std::llround(estimate) << ")";
+}
+
+void print_plan(Operator &op, size_t depth, std::ostream &os){
+    print_operator(op, depth, os);
+    os << '\n';
+    for(std::unique_ptr<Operator> *slot : op.inputs())
+        print_plan(**slot, depth + 1, os);
+}
+
+double milliseconds(uint64_t nanoseconds){
+    return nanoseconds / 1e6;
+}
+
+// Time spent in the inputs of the operator. An input that was never called
+// itself, like a gather that handed out the parts of its own input, counts
+// with the time of its inputs.
+uint64_t input_time(const Node &node){
+    uint64_t result = 0;
+    for(const Node &input : node.inputs){
+        const Counters &counters = *input.counters;
+        result += counters.nanoseconds;
+        if(counters.next_calls == 0 && counters.batch_calls == 0 && counters.resets == 0)
+            result += input_time(input);
+    }
+    return result;
+}
+
+void print_analyzed(const Node &node, size_t depth, std::ostream &os){
+    const Counters &counters = *node.counters;
+
+    uint64_t inputs = input_time(node);
+    uint64_t total = counters.nanoseconds;
+    uint64_t self = total > inputs ? total - inputs : 0;
+
+    print_operator(*node.op, depth, os);
+    os << "  (rows: " << counters.rows
+       << ", next: " << counters.next_calls
+       << ", batches: " << counters.batch_calls
+       << ", resets: " << counters.resets
+       << ", time: " << milliseconds(total) << " ms"
+       << ", self: " << milliseconds(self) << " ms";
+    if(counters.peak_memory > 0)
+        os << ", memory: " << counters.peak_memory << " bytes";
+    os << ")\n";
+
+    for(const Node &input : node.inputs)
+        print_analyzed(input, depth + 1, os);
+}
+
+}
+
+void explain(Operator &root, std::ostream &os){
+    print_plan(root, 0, os);
+}
+
+void explain_analyze(std::unique_ptr<Operator> root, std::ostream &os){
+    auto counters = std::make_shared<Counters>();
+    Node tree = instrument(*root, counters);
+
+    Probe probe(std::move(root), counters);
+    Clock::time_point start = Clock::now();
+    while(!probe.nextBatch().empty());
+    uint64_t elapsed = std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() - start).count();
+
+    std::ios_base::fmtflags flags = os.flags();
+    os << std::fixed << std::setprecision(3);
+    print_analyzed(tree, 0, os);
+    os << "Execution time: " << milliseconds(elapsed) << " ms\n";
+    os.flags(flags);
+}
+
+}
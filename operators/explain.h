@@ -0,0 +1,19 @@
+#pragma once
+#include <iostream>
+#include <memory>
+#include "operator.h"
+
+namespace ToyDBMS {
+
+// Prints the operator tree, every operator indented under the one that reads
+// it, with the number of rows the planner expects it to produce.
+void explain(Operator &root, std::ostream &os);
+
+// Runs the plan, discarding its rows, then prints the tree like explain() with
+// what every operator did: the rows it produced, its next(), nextBatch() and
+// reset() calls, the wall time spent in it with and without its inputs, and
+// the peak memory of its hash tables and materialized rows. The parts of a
+// split operator add up, so below a Gather the times are summed over threads.
+void explain_analyze(std::unique_ptr<Operator> root, std::ostream &os);
+
+}
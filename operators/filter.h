@@ -6,10 +6,17 @@ namespace ToyDBMS {
 
 class Filter : public Operator {
     std::unique_ptr<Operator> child;
-    std::unique_ptr<Predicate> predicate;
+    // a bound predicate is only read, so the parts of a split filter share it
+    std::shared_ptr<Predicate> predicate;
+
+    // filter of a part of the source's input
+    Filter(const Filter &source, std::unique_ptr<Operator> child)
+        : child(std::move(child)), predicate(source.predicate) {}
 public:
     Filter(std::unique_ptr<Operator> child, std::unique_ptr<Predicate> p)
-        : child(std::move(child)), predicate(std::move(p)) {}
+        : child(std::move(child)), predicate(std::move(p)) {
+        predicate->bind(this->child->header());
+    }
 
     const Header &header(){ return child->header(); }
 
@@ -22,9 +29,32 @@ public:
         return row;
     }
 
+    Batch nextBatch() override {
+        while(true){
+            Batch batch = child->nextBatch();
+            if(batch.empty()) return batch;
+            predicate->select(child->header(), batch);
+            if(!batch.empty()) return batch;
+        }
+    }
+
     void reset() override {
         child->reset();
     }
+
+    std::vector<std::unique_ptr<Operator>> split(size_t parts) override {
+        std::vector<std::unique_ptr<Operator>> result = child->split(parts);
+        for(auto &part : result)
+            part.reset(new Filter(*this, std::move(part)));
+        return result;
+    }
+
+    bool pushRuntimeFilter(const std::string &attribute, std::shared_ptr<const RuntimeFilter> filter) override {
+        return child->pushRuntimeFilter(attribute, std::move(filter));
+    }
+
+    std::string describe() override { return "Filter " + predicate->describe(); }
+    std::vector<std::unique_ptr<Operator> *> inputs() override { return {&child}; }
 };
 
 }
@@ -0,0 +1,107 @@
+#include <chrono>
+#include "gather.h"
+
+namespace ToyDBMS {
+
+void Gather::submit(){
+	// one morsel more than threads keeps every thread busy without buffering the whole output
+	size_t window = ThreadPool::threads() + 1;
+
+	while(submitted < parts.size() && submitted < consumed + window){
+		size_t index = submitted++;
+		tasks.run([this, index]{
+			std::vector<Batch> batches;
+			std::exception_ptr thrown;
+			try {
+				for(Batch batch = parts[index]->nextBatch(); !batch.empty(); batch = parts[index]->nextBatch())
+					batches.push_back(std::move(batch));
+			} catch(...){
+				thrown = std::current_exception();
+			}
+
+			std::lock_guard<std::mutex> lock(mutex);
+			morsels[index].batches = std::move(batches);
+			morsels[index].done = true;
+			if(!ordered) finished.push_back(index);
+			if(thrown && !error) error = thrown;
+		});
+	}
+}
+
+size_t Gather::waitForMorsel(){
+	while(true){
+		{
+			std::lock_guard<std::mutex> lock(mutex);
+			if(error) std::rethrow_exception(error);
+
+			if(ordered){
+				if(morsels[consumed].done) return consumed;
+			} else if(!finished.empty()){
+				size_t index = finished.front();
+				finished.pop_front();
+				return index;
+			}
+		}
+
+		// the waiting thread runs morsels too
+		if(!ThreadPool::global().runPendingTask())
+			std::this_thread::sleep_for(std::chrono::microseconds(50));
+	}
+}
+
+Batch Gather::nextBatch(){
+	if(!started){
+		started = true;
+		parts = child->split(ThreadPool::morsels());
+		morsels.resize(parts.size());
+	}
+
+	if(parts.empty())
+		return child->nextBatch();
+
+	while(true){
+		if(current != nullptr && batch_position < current->batches.size())
+			return std::move(current->batches[batch_position++]);
+
+		if(current != nullptr){
+			current->batches.clear();
+			current->batches.shrink_to_fit();
+			current = nullptr;
+		}
+
+		if(consumed == parts.size())
+			return Batch();
+
+		submit();
+		current = &morsels[waitForMorsel()];
+		batch_position = 0;
+		consumed++;
+	}
+}
+
+Row Gather::next(){
+	if(!reader)
+		reader = std::make_unique<BatchReader>(*this);
+	return reader->next();
+}
+
+void Gather::reset(){
+	tasks.wait();
+	reader.reset();
+	current = nullptr;
+	batch_position = 0;
+	submitted = consumed = 0;
+	finished.clear();
+
+	if(parts.empty()){
+		child->reset();
+		return;
+	}
+
+	for(size_t i = 0; i < parts.size(); i++){
+		parts[i]->reset();
+		morsels[i] = Morsel();
+	}
+}
+
+}
@@ -0,0 +1,72 @@
+#pragma once
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <memory>
+#include <mutex>
+#include "operator.h"
+#include "threadpool.h"
+
+namespace ToyDBMS {
+	// Splits its child into morsels and produces them on the global thread pool,
+	// keeping a bounded number of morsels in flight. In ordered mode the output
+	// is in the order of the child, otherwise a morsel's batches are returned as
+	// soon as it is finished. A child that can't be split is read directly.
+	// A gather that has not started yet splits into the parts of its child,
+	// so parallel consumers above it read the child's parts themselves.
+	class Gather : public Operator {
+		struct Morsel {
+			std::vector<Batch> batches;
+			bool done = false;
+		};
+
+		std::unique_ptr<Operator> child;
+		bool ordered;
+
+		bool started = false;
+		std::vector<std::unique_ptr<Operator>> parts;
+		std::vector<Morsel> morsels;
+
+		std::mutex mutex;
+		std::deque<size_t> finished; // morsels in the order they were finished
+		std::exception_ptr error;
+
+		size_t submitted = 0;
+		size_t consumed = 0;
+		Morsel *current = nullptr;
+		size_t batch_position = 0;
+
+		std::unique_ptr<BatchReader> reader;
+
+		// declared last, so in-flight morsels finish before the rest is destroyed
+		TaskGroup tasks;
+
+		public:
+			Gather(std::unique_ptr<Operator> child, bool ordered)
+				: child(std::move(child)), ordered(ordered) {}
+
+			const Header &header() override { return child->header(); }
+			Row next() override;
+			Batch nextBatch() override;
+			void reset() override;
+
+			std::vector<std::unique_ptr<Operator>> split(size_t parts) override {
+				if (started) {
+					return {};
+				}
+
+				return child->split(parts);
+			}
+
+			bool pushRuntimeFilter(const std::string &attribute, std::shared_ptr<const RuntimeFilter> filter) override {
+				return !started && child->pushRuntimeFilter(attribute, std::move(filter));
+			}
+
+			std::string describe() override { return ordered ? "Gather" : "Gather unordered"; }
+			std::vector<std::unique_ptr<Operator> *> inputs() override { return {&child}; }
+
+		private:
+			void submit();
+			size_t waitForMorsel();
+	};
+}
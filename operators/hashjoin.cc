@@ -0,0 +1,224 @@
+#include <algorithm>
+#include <iterator>
+#include "hashjoin.h"
+#include "runtimefilter.h"
+#include "threadpool.h"
+
+namespace ToyDBMS {
+
+constexpr uint32_t HashJoin::NONE;
+
+HashJoin::HashJoin(std::unique_ptr<Operator> left, std::unique_ptr<Operator> right,
+				   std::string left_attr, std::string right_attr, BuildSide buildSide)
+	: build(buildSide == BuildSide::LEFT ? std::move(left) : std::move(right)),
+	  probe(buildSide == BuildSide::LEFT ? std::move(right) : std::move(left)),
+	  buildSide(buildSide) {
+	Operator &leftInput = buildSide == BuildSide::LEFT ? *build : *probe;
+	Operator &rightInput = buildSide == BuildSide::LEFT ? *probe : *build;
+
+	Header header = leftInput.header();
+	const Header &rightHeader = rightInput.header();
+	left_width = header.size();
+	header.insert(header.end(), rightHeader.begin(), rightHeader.end());
+	header_ptr = std::make_shared<Header>(std::move(header));
+
+	build_index = build->header().index(buildSide == BuildSide::LEFT ? left_attr : right_attr);
+	probe_index = probe->header().index(buildSide == BuildSide::LEFT ? right_attr : left_attr);
+}
+
+HashJoin::HashJoin(const HashJoin &source, std::unique_ptr<Operator> probe)
+	: probe(std::move(probe)), header_ptr(source.header_ptr), buildSide(source.buildSide),
+	  left_width(source.left_width), build_index(source.build_index), probe_index(source.probe_index),
+	  hashTable(source.hashTable) {}
+
+void HashJoin::HashTable::insert(const Value &key, const std::vector<Value> &row){
+	uint32_t index = static_cast<uint32_t>(rows());
+	values.insert(values.end(), row.begin(), row.end());
+	next.push_back(NONE);
+
+	auto inserted = chains.emplace(key, std::make_pair(index, index));
+	if(!inserted.second){
+		next[inserted.first->second.second] = index;
+		inserted.first->second.second = index;
+	}
+}
+
+void HashJoin::HashTable::append(const HashTable &other){
+	uint32_t offset = static_cast<uint32_t>(rows());
+	values.insert(values.end(), other.values.begin(), other.values.end());
+	for(uint32_t link : other.next)
+		next.push_back(link == NONE ? NONE : link + offset);
+
+	for(const auto &kv : other.chains){
+		std::pair<uint32_t, uint32_t> chain(kv.second.first + offset, kv.second.second + offset);
+		auto inserted = chains.emplace(kv.first, chain);
+		if(!inserted.second){
+			next[inserted.first->second.second] = chain.first;
+			inserted.first->second.second = chain.second;
+		}
+	}
+}
+
+void HashJoin::HashTable::insertRows(Operator &input, Header::size_type key_index){
+	BatchReader reader(input);
+	for(Row row = reader.next(); row; row = reader.next())
+		insert(row[key_index], row.values);
+}
+
+// With several threads the parts of the build input are hashed into tables of
+// their own, which are then appended in the order of the parts, so every key
+// keeps its rows in input order.
+void HashJoin::buildHashTable(){
+	size_t width = build->header().size();
+	auto table = std::make_shared<HashTable>(width);
+
+	std::vector<std::unique_ptr<Operator>> parts;
+	if(ThreadPool::threads() > 1)
+		parts = build->split(ThreadPool::morsels());
+
+	if(parts.empty()){
+		table->insertRows(*build, build_index);
+	} else {
+		std::vector<HashTable> partTables(parts.size(), HashTable(width));
+		parallel_for(parts.size(), [&](size_t i){
+			partTables[i].insertRows(*parts[i], build_index);
+		});
+
+		size_t rows = 0;
+		for(const HashTable &partTable : partTables)
+			rows += partTable.rows();
+		table->values.reserve(rows * width);
+		table->next.reserve(rows);
+
+		for(const HashTable &partTable : partTables)
+			table->append(partTable);
+	}
+
+	hashTable = std::move(table);
+
+	auto filter = std::make_shared<RuntimeFilter>(hashTable->chains.size());
+	for(const auto &kv : hashTable->chains)
+		filter->add(kv.first);
+	probe->pushRuntimeFilter(probe->header()[probe_index], std::move(filter));
+}
+
+bool HashJoin::pushRuntimeFilter(const std::string &attribute, std::shared_ptr<const RuntimeFilter> filter){
+	const Header &probeHeader = probe->header();
+	if(std::find(probeHeader.begin(), probeHeader.end(), attribute) != probeHeader.end())
+		return probe->pushRuntimeFilter(attribute, std::move(filter));
+
+	return !hashTable && build->pushRuntimeFilter(attribute, std::move(filter));
+}
+
+std::string HashJoin::describe(){
+	const std::string &buildAttribute = build->header()[build_index];
+	const std::string &probeAttribute = probe->header()[probe_index];
+	if(buildSide == BuildSide::LEFT)
+		return "HashJoin " + buildAttribute + " = " + probeAttribute + ", build left";
+	return "HashJoin " + probeAttribute + " = " + buildAttribute + ", build right";
+}
+
+std::vector<std::unique_ptr<Operator> *> HashJoin::inputs(){
+	if(buildSide == BuildSide::LEFT)
+		return {&build, &probe};
+	return {&probe, &build};
+}
+
+size_t HashJoin::memoryUsage(){
+	if(!hashTable)
+		return 0;
+
+	return hashTable->values.capacity() * sizeof(Value) + hashTable->next.capacity() * sizeof(uint32_t)
+		+ hash_table_bytes(hashTable->chains);
+}
+
+std::vector<std::unique_ptr<Operator>> HashJoin::split(size_t parts){
+	if(!hashTable)
+		buildHashTable();
+
+	std::vector<std::unique_ptr<Operator>> result = probe->split(parts);
+	for(auto &part : result)
+		part.reset(new HashJoin(*this, std::move(part)));
+	return result;
+}
+
+Row HashJoin::combine(const Row &probeRow, const Value *buildRow){
+	std::vector<Value> values;
+	values.reserve(probeRow.size() + hashTable->width);
+	if(buildSide == BuildSide::LEFT){
+		values.insert(values.end(), buildRow, buildRow + hashTable->width);
+		values.insert(values.end(), probeRow.values.begin(), probeRow.values.end());
+	} else {
+		values.insert(values.end(), probeRow.values.begin(), probeRow.values.end());
+		values.insert(values.end(), buildRow, buildRow + hashTable->width);
+	}
+
+	return Row(std::move(values));
+}
+
+Row HashJoin::next(){
+	if(!hashTable)
+		buildHashTable();
+
+	while(true){
+		if(match != NONE){
+			const Value *buildRow = hashTable->row(match);
+			match = hashTable->next[match];
+			return combine(current_probe, buildRow);
+		}
+
+		current_probe = probe->next();
+		if(!current_probe) return {};
+
+		auto it = hashTable->chains.find(current_probe[probe_index]);
+		match = it == hashTable->chains.end() ? NONE : it->second.first;
+	}
+}
+
+Batch HashJoin::nextBatch(){
+	if(!hashTable)
+		buildHashTable();
+
+	Batch result(header_ptr->size());
+
+	while(!result.full()){
+		if(match != NONE){
+			const Value *buildRow = hashTable->row(match);
+			match = hashTable->next[match];
+			uint32_t position = probe_batch.selection[probe_position - 1];
+
+			size_t probe_offset = buildSide == BuildSide::LEFT ? left_width : 0;
+			size_t build_offset = buildSide == BuildSide::LEFT ? 0 : left_width;
+			for(size_t i = 0; i < probe_batch.columns.size(); i++)
+				result.columns[probe_offset + i].push_back(probe_batch.columns[i][position]);
+			for(size_t i = 0; i < hashTable->width; i++)
+				result.columns[build_offset + i].push_back(buildRow[i]);
+			result.commit();
+			continue;
+		}
+
+		if(probe_position == probe_batch.size()){
+			probe_batch = probe->nextBatch();
+			probe_position = 0;
+			if(probe_batch.empty()) break;
+		}
+
+		uint32_t position = probe_batch.selection[probe_position++];
+		auto it = hashTable->chains.find(probe_batch.columns[probe_index][position]);
+		match = it == hashTable->chains.end() ? NONE : it->second.first;
+	}
+
+	return result;
+}
+
+// The hash table depends only on the build input, so it survives a reset
+// and only the probe side is rescanned.
+void HashJoin::reset(){
+	probe->reset();
+	current_probe = {};
+	match = NONE;
+	probe_batch = Batch();
+	probe_position = 0;
+}
+
+}
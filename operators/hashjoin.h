@@ -0,0 +1,84 @@
+#pragma once
+#include <memory>
+#include <unordered_map>
+#include "arena.h"
+#include "operator.h"
+
+namespace ToyDBMS {
+	// Equi-join through a hash table of the build input. Once the table is built
+	// a runtime filter of its keys is handed to the probe input, so the probe
+	// side can drop rows without a match before they reach the join. The table
+	// and the build rows live in the query's arena.
+	class HashJoin : public Operator {
+		public:
+			enum class BuildSide { LEFT, RIGHT };
+
+		private:
+			static constexpr uint32_t NONE = UINT32_MAX;
+
+			// The build rows are stored one after another; the rows with the same key
+			// are chained in input order, from the first one to the last.
+			struct HashTable {
+				size_t width;
+				std::vector<Value, ArenaAllocator<Value>> values;
+				std::vector<uint32_t, ArenaAllocator<uint32_t>> next;
+				std::unordered_map<Value, std::pair<uint32_t, uint32_t>, std::hash<Value>, std::equal_to<Value>,
+								   ArenaAllocator<std::pair<const Value, std::pair<uint32_t, uint32_t>>>> chains;
+
+				explicit HashTable(size_t width): width(width) {}
+
+				size_t rows() const { return next.size(); }
+				const Value *row(uint32_t index) const { return values.data() + index * width; }
+
+				void insert(const Value &key, const std::vector<Value> &row);
+				void insertRows(Operator &input, Header::size_type key_index);
+
+				// appends the rows of the other table after the ones of this table
+				void append(const HashTable &other);
+			};
+
+			std::unique_ptr<Operator> build, probe;
+			std::shared_ptr<Header> header_ptr;
+
+			BuildSide buildSide;
+			size_t left_width;
+			Header::size_type build_index, probe_index;
+
+			// built once and only read afterwards, so the parts of a split join share it
+			std::shared_ptr<const HashTable> hashTable;
+
+			Row current_probe;
+			uint32_t match = NONE;
+
+			Batch probe_batch;
+			size_t probe_position = 0;
+
+		public:
+			// Output rows are always laid out as left ++ right. When the right side is
+			// the build side the output keeps the order of the left input, exactly like NLJoin.
+			HashJoin(std::unique_ptr<Operator> left, std::unique_ptr<Operator> right,
+					 std::string left_attr, std::string right_attr, BuildSide buildSide);
+
+			const Header &header() override { return *header_ptr; }
+			Row next() override;
+			Batch nextBatch() override;
+			void reset() override;
+
+			// Builds the hash table and splits the probe side.
+			std::vector<std::unique_ptr<Operator>> split(size_t parts) override;
+
+			// Passes the filter to the input with the attribute, the build input only if not built yet.
+			bool pushRuntimeFilter(const std::string &attribute, std::shared_ptr<const RuntimeFilter> filter) override;
+
+			std::string describe() override;
+			std::vector<std::unique_ptr<Operator> *> inputs() override;
+			size_t memoryUsage() override;
+
+		private:
+			// probes a part of the source's probe input with the source's hash table
+			HashJoin(const HashJoin &source, std::unique_ptr<Operator> probe);
+
+			void buildHashTable();
+			Row combine(const Row &probeRow, const Value *buildRow);
+	};
+}
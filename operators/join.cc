@@ -26,27 +26,75 @@ Row AbstractNLJoin::next(){
 			continue;
         }
 
-        std::vector<Value> values = current_left.values;
+        std::vector<Value> values;
+        values.reserve(current_left.size() + current_right.size());
+        values.insert(values.end(), current_left.values.begin(), current_left.values.end());
         values.insert(values.end(),
                       std::make_move_iterator(current_right.values.begin()),
                       std::make_move_iterator(current_right.values.end()));
 
-        return {header_ptr, std::move(values)};
+        return Row(std::move(values));
     }
 }
 
+Batch AbstractNLJoin::nextBatch(){
+    Batch result(header_ptr->size());
+    size_t left_width = left->header().size();
+
+    while(!result.full()){
+        if(!current_left){
+            current_left = left->next();
+            if(!current_left) break;
+
+            right->reset();
+            right_batch = Batch();
+            right_position = 0;
+        }
+
+        if(right_position == right_batch.size()){
+            right_batch = right->nextBatch();
+            right_position = 0;
+            if(right_batch.empty()){
+                current_left = {};
+                continue;
+            }
+        }
+
+        uint32_t position = right_batch.selection[right_position++];
+        if(!isAcceptable(current_left, right_batch, position)) continue;
+
+        for(size_t i = 0; i < left_width; i++)
+            result.columns[i].push_back(current_left.values[i]);
+        for(size_t i = 0; i < right_batch.columns.size(); i++)
+            result.columns[left_width + i].push_back(right_batch.columns[i][position]);
+        result.commit();
+    }
+
+    return result;
+}
+
 void AbstractNLJoin::reset(){
     left->reset();
     right->reset();
     current_left = {};
+    right_batch = Batch();
+    right_position = 0;
 }
 
 bool NLJoin::isAcceptable(const Row &leftRow, const Row &rightRow) {
 	return leftRow[left_index] == rightRow[right_index];
 }
 
+bool NLJoin::isAcceptable(const Row &leftRow, const Batch &rightBatch, uint32_t position) {
+	return leftRow[left_index] == rightBatch.columns[right_index][position];
+}
+
 bool CrossJoin::isAcceptable(const Row &leftRow, const Row &rightRow) {
 	return true;
 }
 
+bool CrossJoin::isAcceptable(const Row &leftRow, const Batch &rightBatch, uint32_t position) {
+	return true;
+}
+
 }
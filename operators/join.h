@@ -11,6 +11,9 @@ namespace ToyDBMS {
 			std::shared_ptr<Header> header_ptr;
 			Row current_left;
 
+			Batch right_batch;
+			size_t right_position = 0;
+
 			Header construct_header(const Header &h1, const Header &h2){
 				Header res {h1};
 				res.insert(res.end(), h2.begin(), h2.end());
@@ -26,10 +29,14 @@ namespace ToyDBMS {
 
 			const Header &header() override { return *header_ptr; }
 			Row next() override;
+			Batch nextBatch() override;
 			void reset() override;
 
+			std::vector<std::unique_ptr<Operator> *> inputs() override { return {&left, &right}; }
+
 		protected:
 			virtual bool isAcceptable(const Row &leftRow, const Row &rightRow) = 0;
+			virtual bool isAcceptable(const Row &leftRow, const Batch &rightBatch, uint32_t position) = 0;
 	};
 
 	class NLJoin : public AbstractNLJoin {
@@ -44,8 +51,11 @@ namespace ToyDBMS {
 				  left_index(this->left->header().index(left_attr)),
 				  right_index(this->right->header().index(right_attr)) {}
 
+			std::string describe() override { return "NLJoin " + left_attr + " = " + right_attr; }
+
 		protected:
 			bool isAcceptable(const Row &leftRow, const Row &rightRow) override;
+			bool isAcceptable(const Row &leftRow, const Batch &rightBatch, uint32_t position) override;
 	};
 
 	class CrossJoin : public AbstractNLJoin {
@@ -55,7 +65,10 @@ namespace ToyDBMS {
 			CrossJoin(std::unique_ptr<Operator> left, std::unique_ptr<Operator> right)
 				: AbstractNLJoin(std::move(left), std::move(right)) {}
 
+			std::string describe() override { return "CrossJoin"; }
+
 		protected:
 			bool isAcceptable(const Row &leftRow, const Row &rightRow) override;
+			bool isAcceptable(const Row &leftRow, const Batch &rightBatch, uint32_t position) override;
 	};
 }
@@ -0,0 +1,56 @@
+#pragma once
+
+#include "operator.h"
+
+namespace ToyDBMS {
+	// Passes on the first rows of its input and stops reading the input once
+	// it has produced them, so nothing below it does work for rows that are
+	// never returned.
+	class Limit : public Operator {
+		private:
+			std::unique_ptr<Operator> child;
+			size_t limit;
+			size_t produced = 0;
+
+		public:
+			Limit(std::unique_ptr<Operator> child, size_t limit)
+				: child(std::move(child)), limit(limit) {}
+
+			const Header &header() override { return child->header(); }
+
+			Row next() override {
+				if (produced == limit) {
+					return {};
+				}
+
+				Row row = child->next();
+				if (row) {
+					produced++;
+				}
+
+				return row;
+			}
+
+			Batch nextBatch() override {
+				if (produced == limit) {
+					return Batch(header().size());
+				}
+
+				Batch batch = child->nextBatch();
+				if (batch.size() > limit - produced) {
+					batch.selection.resize(limit - produced);
+				}
+
+				produced += batch.size();
+				return batch;
+			}
+
+			void reset() override {
+				child->reset();
+				produced = 0;
+			}
+
+			std::string describe() override { return "Limit " + std::to_string(limit); }
+			std::vector<std::unique_ptr<Operator> *> inputs() override { return {&child}; }
+	};
+}
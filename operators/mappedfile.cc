@@ -0,0 +1,39 @@
+#include <stdexcept>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include "mappedfile.h"
+
+namespace ToyDBMS {
+
+MappedFile::MappedFile(const std::string &filename){
+    fd = open(filename.c_str(), O_RDONLY);
+    if(fd == -1)
+        throw std::runtime_error("failed to open file: " + filename);
+
+    struct stat file_stat;
+    if(fstat(fd, &file_stat) == -1){
+        close(fd);
+        throw std::runtime_error("failed to stat file: " + filename);
+    }
+
+    length = file_stat.st_size;
+    if(length == 0) return;
+
+    void *mapped = mmap(nullptr, length, PROT_READ, MAP_PRIVATE, fd, 0);
+    if(mapped == MAP_FAILED){
+        close(fd);
+        throw std::runtime_error("failed to map file: " + filename);
+    }
+
+    madvise(mapped, length, MADV_SEQUENTIAL);
+    bytes = static_cast<const char *>(mapped);
+}
+
+MappedFile::~MappedFile(){
+    if(bytes) munmap(const_cast<char *>(bytes), length);
+    close(fd);
+}
+
+}
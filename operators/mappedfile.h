@@ -0,0 +1,24 @@
+#pragma once
+#include <cstddef>
+#include <string>
+
+namespace ToyDBMS {
+
+// Read-only memory mapping of a whole file. An empty file maps to an empty range.
+class MappedFile {
+    int fd = -1;
+    const char *bytes = nullptr;
+    size_t length = 0;
+public:
+    MappedFile(const std::string &filename);
+    ~MappedFile();
+
+    MappedFile(const MappedFile &) = delete;
+    MappedFile &operator=(const MappedFile &) = delete;
+
+    const char *begin() const { return bytes; }
+    const char *end() const { return bytes + length; }
+    size_t size() const { return length; }
+};
+
+}
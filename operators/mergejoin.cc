@@ -0,0 +1,65 @@
+#include <algorithm>
+#include <iterator>
+#include "mergejoin.h"
+
+namespace ToyDBMS {
+
+Row MergeJoin::combine(const Row &leftRow, const Row &rightRow){
+	std::vector<Value> values;
+	values.reserve(leftRow.size() + rightRow.size());
+	values.insert(values.end(), leftRow.values.begin(), leftRow.values.end());
+	values.insert(values.end(), rightRow.values.begin(), rightRow.values.end());
+
+	return Row(std::move(values));
+}
+
+bool MergeJoin::fillRightRun(const Value &key){
+	right_run.clear();
+
+	while(next_right && precedes(next_right[right_index], key))
+		next_right = right->next();
+
+	while(next_right && next_right[right_index] == key){
+		right_run.push_back(std::move(next_right));
+		next_right = right->next();
+	}
+
+	return !right_run.empty();
+}
+
+Row MergeJoin::next(){
+	if(!started){
+		next_right = right->next();
+		started = true;
+	}
+
+	while(true){
+		if(current_left && run_position < right_run.size()){
+			return combine(current_left, right_run[run_position++]);
+		}
+
+		current_left = left->next();
+		if(!current_left) return {};
+
+		run_position = 0;
+		const Value &key = current_left[left_index];
+
+		// a left duplicate replays the run collected for the previous left row
+		if(!right_run.empty() && right_run.front()[right_index] == key)
+			continue;
+
+		if(!fillRightRun(key) && !next_right) return {};
+	}
+}
+
+void MergeJoin::reset(){
+	left->reset();
+	right->reset();
+	current_left = {};
+	next_right = {};
+	started = false;
+	right_run.clear();
+	run_position = 0;
+}
+
+}
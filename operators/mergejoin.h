@@ -0,0 +1,60 @@
+#pragma once
+#include <memory>
+#include "operator.h"
+
+namespace ToyDBMS {
+	// Joins two inputs that are both sorted on their join attributes in the same
+	// direction. Both inputs are read once; only the current run of equal keys of
+	// the right input is kept in memory, so duplicates on either side are handled.
+	// The output is ordered on the join key and keeps the order of the left input.
+	class MergeJoin : public Operator {
+		std::unique_ptr<Operator> left, right;
+		std::shared_ptr<Header> header_ptr;
+
+		Header::size_type left_index, right_index;
+		bool descending;
+
+		Row current_left;
+		Row next_right;
+		bool started = false;
+
+		std::vector<Row> right_run;
+		size_t run_position = 0;
+
+		Header construct_header(const Header &h1, const Header &h2){
+			Header res {h1};
+			res.insert(res.end(), h2.begin(), h2.end());
+			return res;
+		}
+
+		public:
+			MergeJoin(std::unique_ptr<Operator> left, std::unique_ptr<Operator> right,
+					  std::string left_attr, std::string right_attr, bool descending)
+				: left(std::move(left)), right(std::move(right)),
+				  header_ptr(std::make_shared<Header>(
+					construct_header(this->left->header(), this->right->header()))
+				  ),
+				  left_index(this->left->header().index(left_attr)),
+				  right_index(this->right->header().index(right_attr)),
+				  descending(descending) {}
+
+			const Header &header() override { return *header_ptr; }
+			Row next() override;
+			void reset() override;
+
+			std::string describe() override {
+				return "MergeJoin " + left->header()[left_index] + " = " + right->header()[right_index]
+					+ (descending ? ", descending" : "");
+			}
+
+			std::vector<std::unique_ptr<Operator> *> inputs() override { return {&left, &right}; }
+
+		private:
+			bool precedes(const Value &a, const Value &b) const {
+				return descending ? a > b : a < b;
+			}
+
+			bool fillRightRun(const Value &key);
+			Row combine(const Row &leftRow, const Row &rightRow);
+	};
+}
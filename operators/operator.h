@@ -1,14 +1,113 @@
 #pragma once
+#include <memory>
+#include <string>
 #include "row.h"
+#include "batch.h"
 
 namespace ToyDBMS {
 
+class RuntimeFilter;
+
 class Operator {
 public:
     virtual ~Operator(){}
     virtual const Header &header() = 0;
     virtual Row  next()  = 0;
     virtual void reset() = 0;
+
+    // Returns up to Batch::CAPACITY tuples, an empty batch at the end of input.
+    // The default implementation collects rows from next(), so operators
+    // without a batch implementation can still be used in batch pipelines.
+    // A consumer should read a child either by rows or by batches between resets.
+    virtual Batch nextBatch(){
+        Batch batch(header().size());
+        while(!batch.full()){
+            Row row = next();
+            if(!row) break;
+            batch.append(std::move(row.values));
+        }
+        return batch;
+    }
+
+    // Splits the output of a freshly created or reset operator into at most
+    // `parts` operators that may be read concurrently. Reading the parts one
+    // after another gives the same tuples in the same order. Returns no parts
+    // if the operator can't be split; after a split only the parts are read.
+    virtual std::vector<std::unique_ptr<Operator>> split(size_t parts){
+        return {};
+    }
+
+    // Offers a filter on an attribute of the output whose consumer discards
+    // the rows the filter rejects, so they may be dropped as early as possible.
+    // Returns true if the filter is applied. Called before the output is read.
+    virtual bool pushRuntimeFilter(const std::string &attribute, std::shared_ptr<const RuntimeFilter> filter){
+        return false;
+    }
+
+    // The name of the operator and its parameters, as shown by EXPLAIN.
+    virtual std::string describe() = 0;
+
+    // The slots of the operators this one reads, so that EXPLAIN can walk the
+    // tree and EXPLAIN ANALYZE can put probes into them before execution.
+    virtual std::vector<std::unique_ptr<Operator> *> inputs(){
+        return {};
+    }
+
+    // Approximate bytes of hash tables and materialized rows the operator holds.
+    virtual size_t memoryUsage(){
+        return 0;
+    }
+
+    // Rows the planner expects the operator to produce. An operator without an
+    // estimate of its own is expected to produce as many as its first input,
+    // a negative number means that nothing is known.
+    double estimatedRows(){
+        if(estimated_rows >= 0) return estimated_rows;
+        std::vector<std::unique_ptr<Operator> *> in = inputs();
+        return in.empty() ? -1 : (*in.front())->estimatedRows();
+    }
+
+    void setEstimatedRows(double rows){ estimated_rows = rows; }
+
+private:
+    double estimated_rows = -1;
+};
+
+// The attributes separated by commas, for descriptions of operators.
+inline std::string attribute_list(const std::vector<std::string> &attributes){
+    std::string result;
+    for(const std::string &attribute : attributes){
+        if(!result.empty()) result += ", ";
+        result += attribute;
+    }
+    return result;
+}
+
+// Approximate bytes of a node-based hash container: one node with a link and
+// a cached hash per element, and the bucket array.
+template<typename Table>
+size_t hash_table_bytes(const Table &table){
+    return table.size() * (sizeof(typename Table::value_type) + 2 * sizeof(void *))
+         + table.bucket_count() * sizeof(void *);
+}
+
+// Reads an operator in batch mode and hands out its tuples as rows.
+class BatchReader {
+    Operator &source;
+    Batch batch;
+    size_t position = 0;
+public:
+    BatchReader(Operator &source)
+        : source(source) {}
+
+    Row next(){
+        if(position == batch.size()){
+            batch = source.nextBatch();
+            position = 0;
+            if(batch.empty()) return {};
+        }
+        return Row(batch.values(batch.selection[position++]));
+    }
 };
 
 }
@@ -27,9 +27,29 @@ public:
         return row;
     }
 
+    Batch nextBatch() override {
+        if(first){
+            std::cout << header() << '\n';
+            first = false;
+        }
+
+        Batch batch = child->nextBatch();
+        for(uint32_t position : batch.selection){
+            for(size_t i = 0; i < batch.columns.size(); i++){
+                if(i > 0) std::cout << '\t';
+                std::cout << batch.columns[i][position];
+            }
+            std::cout << '\n';
+        }
+        return batch;
+    }
+
     void reset() override {
         child->reset();
     }
+
+    std::string describe() override { return "Print"; }
+    std::vector<std::unique_ptr<Operator> *> inputs() override { return {&child}; }
 };
 
 }
@@ -10,10 +10,31 @@ namespace ToyDBMS {
 		std::vector<Value> values;
 		values.reserve(header_ptr->size());
 
-		for (const std::string &attributeName : *header_ptr) {
-			values.push_back(row[row.header->index(attributeName)]);
+		for (Header::size_type index : indices) {
+			values.push_back(row.values[index]);
 		}
 
-		return {header_ptr, std::move(values)};
+		return Row(std::move(values));
+	}
+
+	Batch Projection::nextBatch(){
+		Batch batch = child->nextBatch();
+		if (batch.empty()) {
+			return batch;
+		}
+
+		// whole columns are moved; a column projected several times is copied for all but its last use
+		std::vector<std::vector<Value>> columns(indices.size());
+		for (size_t i = 0; i < indices.size(); i++) {
+			bool usedLater = std::find(indices.begin() + i + 1, indices.end(), indices[i]) != indices.end();
+			if (usedLater) {
+				columns[i] = batch.columns[indices[i]];
+			} else {
+				columns[i] = std::move(batch.columns[indices[i]]);
+			}
+		}
+
+		batch.columns = std::move(columns);
+		return batch;
 	}
 }
@@ -8,13 +8,38 @@ namespace ToyDBMS {
 			std::unique_ptr<Operator> child;
 			std::shared_ptr<Header> header_ptr;
 
+			// slot of every output attribute in the child rows
+			std::vector<Header::size_type> indices;
+
 		public:
 			Projection(std::unique_ptr<Operator> child, Header &&header)
 				: child(std::move(child)),
-				  header_ptr(std::make_shared<Header>(header)) {}
+				  header_ptr(std::make_shared<Header>(header)) {
+				indices.reserve(header_ptr->size());
+				for (const std::string &attributeName : *header_ptr) {
+					indices.push_back(this->child->header().index(attributeName));
+				}
+			}
 
 			const Header &header() override { return *header_ptr; }
 			Row next() override;
+			Batch nextBatch() override;
 			void reset() override { child->reset(); }
+
+			std::vector<std::unique_ptr<Operator>> split(size_t parts) override {
+				std::vector<std::unique_ptr<Operator>> result = child->split(parts);
+				for (auto &part : result) {
+					part = std::make_unique<Projection>(std::move(part), Header(*header_ptr));
+				}
+
+				return result;
+			}
+
+			bool pushRuntimeFilter(const std::string &attribute, std::shared_ptr<const RuntimeFilter> filter) override {
+				return child->pushRuntimeFilter(attribute, std::move(filter));
+			}
+
+			std::string describe() override { return "Projection " + attribute_list(*header_ptr); }
+			std::vector<std::unique_ptr<Operator> *> inputs() override { return {&child}; }
 	};
 }
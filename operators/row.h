@@ -1,4 +1,7 @@
 #pragma once
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
 #include <iostream>
 #include <memory>
 #include <stdexcept>
@@ -6,59 +9,122 @@
 #include <utility>
 #include <vector>
 #include <functional>
+#include "arena.h"
 
 namespace ToyDBMS {
 
-struct Value {
-    enum class Type { INT, STR };
+// A 16 byte tagged value. Strings of up to INLINE_LENGTH characters are stored
+// in the value itself, longer ones are interned in the current Arena. Every string
+// has exactly one representation, so equality and hashing look at the 16 bytes
+// only, without reading the characters.
+struct alignas(8) Value {
+    enum class Type : uint8_t { INT, STR };
+    static constexpr size_t INLINE_LENGTH = 14;
+
     Type type;
-    int intval;
-    std::string strval;
 
-    Value(int i): type(Type::INT), intval(i) {}
-    Value(std::string s): type(Type::STR), strval(s) {}
+private:
+    static constexpr uint8_t INTERNED = 0xff;
+
+    uint8_t length = 0;          // of an inline string, INTERNED otherwise
+    char chars[INLINE_LENGTH];   // inline string, or the int or pointer at chars + PAYLOAD
+
+    // the int and the pointer are kept 8-byte aligned
+    static constexpr size_t PAYLOAD = 6;
+
+    void setString(const char *begin, const char *end){
+        std::memset(chars, 0, sizeof(chars));
+        size_t size = end - begin;
+        if(size <= INLINE_LENGTH){
+            length = static_cast<uint8_t>(size);
+            std::memcpy(chars, begin, size);
+        } else {
+            length = INTERNED;
+            const InternedString *interned = Arena::current().intern(begin, end);
+            std::memcpy(chars + PAYLOAD, &interned, sizeof(interned));
+        }
+    }
+
+    const InternedString *interned() const {
+        const InternedString *result;
+        std::memcpy(&result, chars + PAYLOAD, sizeof(result));
+        return result;
+    }
+
+    uint64_t word(size_t i) const {
+        uint64_t result;
+        std::memcpy(&result, reinterpret_cast<const char *>(this) + 8 * i, sizeof(result));
+        return result;
+    }
+
+public:
+    Value(int i): type(Type::INT) {
+        std::memset(chars, 0, sizeof(chars));
+        std::memcpy(chars + PAYLOAD, &i, sizeof(i));
+    }
+
+    Value(const char *begin, const char *end): type(Type::STR) {
+        setString(begin, end);
+    }
+
+    Value(const std::string &s): Value(s.data(), s.data() + s.size()) {}
+
     Value(std::string v, Type type): type(type) {
-        if(type == Type::INT) intval = std::stoi(v);
-        else strval = v;
+        if(type == Type::INT){
+            int i = std::stoi(v);
+            std::memset(chars, 0, sizeof(chars));
+            std::memcpy(chars + PAYLOAD, &i, sizeof(i));
+        } else {
+            setString(v.data(), v.data() + v.size());
+        }
+    }
+
+    int intval() const {
+        int result;
+        std::memcpy(&result, chars + PAYLOAD, sizeof(result));
+        return result;
+    }
+
+    const char *data() const { return length == INTERNED ? interned()->data : chars; }
+    size_t size() const { return length == INTERNED ? interned()->size : length; }
+    std::string strval() const { return std::string(data(), size()); }
+
+    size_t hash() const {
+        // multiplying spreads the aligned pointers and small ints over all bits
+        uint64_t h = (word(0) ^ (word(1) * 0x9e3779b97f4a7c15ULL)) * 0xff51afd7ed558ccdULL;
+        return static_cast<size_t>(h ^ (h >> 32));
     }
 
     bool operator==(const Value &other) const {
-        if(type != other.type) return false;
-        switch(type){
-        case Type::INT:
-            return intval == other.intval;
-        case Type::STR:
-            return strval == other.strval;
-        default: throw std::runtime_error("unknown value type");
-        }
+        return word(0) == other.word(0) && word(1) == other.word(1);
     }
 
     bool operator!=(const Value &other) const {
         return !(*this == other);
     }
 
-    bool operator<(const Value &other) const {
+    int compare(const Value &other) const {
         if(type != other.type)
             throw std::runtime_error("can't compare values of two different types");
         switch(type){
         case Type::INT:
-            return intval < other.intval;
-        case Type::STR:
-            return strval < other.strval;
+            return intval() < other.intval() ? -1 : intval() > other.intval();
+        case Type::STR: {
+            size_t size = this->size(), otherSize = other.size();
+            int result = std::memcmp(data(), other.data(), std::min(size, otherSize));
+            if(result != 0) return result;
+            return size < otherSize ? -1 : size > otherSize;
+        }
         default: throw std::runtime_error("unknown value type");
         }
     }
 
+    bool operator<(const Value &other) const {
+        return compare(other) < 0;
+    }
+
     bool operator>(const Value &other) const {
-        if(type != other.type)
-            throw std::runtime_error("can't compare values of two different types");
-        switch(type){
-        case Type::INT:
-            return intval > other.intval;
-        case Type::STR:
-            return strval > other.strval;
-        default: throw std::runtime_error("unknown value type");
-        }
+        return compare(other) > 0;
     }
 
     bool operator <= (const Value &other) const {
@@ -70,6 +136,8 @@ struct Value {
 	}
 };
 
+static_assert(sizeof(Value) == 16, "Value is expected to take 16 bytes");
+
 struct Header : public std::vector<std::string> {
     using vector::vector;
 
@@ -80,15 +148,16 @@ struct Header : public std::vector<std::string> {
     }
 };
 
+// The values of a tuple. A row does not know its attributes: they are given
+// by the header() of the operator that produced it, which maps names to slots.
 struct Row {
     using size_type = std::vector<Value>::size_type;
-    std::shared_ptr<Header> header;
     std::vector<Value> values;
 
     Row(){}
 
-    Row(const std::shared_ptr<Header> &header, std::vector<Value> &&values)
-        : header(header), values(std::move(values)) {}
+    explicit Row(std::vector<Value> &&values)
+        : values(std::move(values)) {}
 
     Row(const Row &other) = default;
     Row(Row &&other) = default;
@@ -99,18 +168,10 @@ struct Row {
         return values[i];
     }
 
-    Value &operator[](std::string attr){
-        return values[header->index(attr)];
-    }
-
     const Value &operator[](size_type i) const {
         return values[i];
     }
 
-    const Value &operator[](std::string attr) const {
-        return values[header->index(attr)];
-    }
-
     bool operator==(const Row &other) const {
     	for (size_t i = 0; i < values.size(); i++) {
     		if (values[i] != other.values[i]) {
@@ -137,9 +198,9 @@ inline std::ostream &operator<<(std::ostream &os, const Header &header){
 inline std::ostream &operator<<(std::ostream &os, const Value &val){
     switch(val.type){
     case Value::Type::INT:
-        return os << val.intval;
+        return os << val.intval();
     case Value::Type::STR:
-        return os << val.strval;
+        return os.write(val.data(), val.size());
     default: throw std::runtime_error("unknown value type");
     }
 }
@@ -157,20 +218,7 @@ namespace std {
 template <>
 struct hash<ToyDBMS::Value> {
 	size_t operator()(const ToyDBMS::Value &v) const {
-		switch (v.type) {
-			case ToyDBMS::Value::Type::INT: {
-				std::hash<int> hasher;
-				return hasher(v.intval);
-			}
-
-			case ToyDBMS::Value::Type::STR: {
-				std::hash<std::string> hasher;
-				return hasher(v.strval);
-			}
-
-			default:
-				throw std::runtime_error("Unexpected Value type");
-		}
+		return v.hash();
 	}
 };
 
@@ -0,0 +1,50 @@
+#include "runtimefilter.h"
+
+namespace ToyDBMS {
+
+RuntimeFilter::RuntimeFilter(size_t expected){
+    size_t bits = 64;
+    while(bits < expected * BITS_PER_KEY) bits *= 2;
+    words.assign(bits / 64, 0);
+    mask = bits - 1;
+}
+
+// std::hash<int> is the identity, so the hash is mixed before its bits are used
+uint64_t RuntimeFilter::hash(const Value &key){
+    uint64_t h = std::hash<Value>()(key);
+    h ^= h >> 33;
+    h *= 0xff51afd7ed558ccdULL;
+    h ^= h >> 33;
+    h *= 0xc4ceb9fe1a85ec53ULL;
+    h ^= h >> 33;
+    return h;
+}
+
+void RuntimeFilter::add(const Value &key){
+    if(empty){
+        minimum = maximum = key;
+        empty = false;
+    } else {
+        if(key < minimum) minimum = key;
+        if(maximum < key) maximum = key;
+    }
+
+    uint64_t h = hash(key);
+    uint64_t step = (h >> 32) | 1;
+    for(unsigned i = 0; i < HASHES; i++, h += step)
+        words[(h & mask) >> 6] |= uint64_t(1) << (h & 63);
+}
+
+bool RuntimeFilter::mayContain(const Value &key) const {
+    if(empty || key.type != minimum.type) return false;
+    if(key < minimum || maximum < key) return false;
+
+    uint64_t h = hash(key);
+    uint64_t step = (h >> 32) | 1;
+    for(unsigned i = 0; i < HASHES; i++, h += step){
+        if(!(words[(h & mask) >> 6] & (uint64_t(1) << (h & 63)))) return false;
+    }
+    return true;
+}
+
+}
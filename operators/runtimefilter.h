@@ -0,0 +1,35 @@
+#pragma once
+#include <cstdint>
+#include <vector>
+#include "row.h"
+
+namespace ToyDBMS {
+
+// Summary of the join keys of a hash join's build side, handed to the probe
+// side so that scans can drop rows without a match before materializing them.
+// The range of the keys rejects values outside [min, max] without hashing,
+// a Bloom filter rejects most of the others. There are no false negatives.
+class RuntimeFilter {
+    static constexpr unsigned HASHES = 3;
+    static constexpr size_t BITS_PER_KEY = 8;
+
+    std::vector<uint64_t> words;
+    uint64_t mask;
+
+    bool empty = true;
+    Value minimum = Value(0), maximum = Value(0);
+
+public:
+    // expected is the number of distinct keys that will be added
+    explicit RuntimeFilter(size_t expected);
+
+    // All the keys have to be of the same type.
+    void add(const Value &key);
+
+    bool mayContain(const Value &key) const;
+
+private:
+    static uint64_t hash(const Value &key);
+};
+
+}
@@ -0,0 +1,72 @@
+#include "semijoin.h"
+#include "runtimefilter.h"
+
+namespace ToyDBMS {
+
+void HashSemiJoin::buildKeys(){
+	auto set = std::make_shared<KeySet>();
+	while(true){
+		Batch batch = right->nextBatch();
+		if(batch.empty()) break;
+
+		const std::vector<Value> &column = batch.columns[right_index];
+		for(uint32_t position : batch.selection)
+			set->insert(column[position]);
+	}
+
+	keys = std::move(set);
+
+	if(!anti){
+		auto filter = std::make_shared<RuntimeFilter>(keys->size());
+		for(const Value &key : *keys)
+			filter->add(key);
+		left->pushRuntimeFilter(left->header()[left_index], std::move(filter));
+	}
+}
+
+std::vector<std::unique_ptr<Operator>> HashSemiJoin::split(size_t parts){
+	if(!keys)
+		buildKeys();
+
+	std::vector<std::unique_ptr<Operator>> result = left->split(parts);
+	for(auto &part : result)
+		part.reset(new HashSemiJoin(*this, std::move(part)));
+	return result;
+}
+
+Row HashSemiJoin::next(){
+	if(!keys)
+		buildKeys();
+
+	while(true){
+		Row row = left->next();
+		if(!row || accepts(row[left_index])) return row;
+	}
+}
+
+Batch HashSemiJoin::nextBatch(){
+	if(!keys)
+		buildKeys();
+
+	while(true){
+		Batch batch = left->nextBatch();
+		if(batch.empty()) return batch;
+
+		const std::vector<Value> &column = batch.columns[left_index];
+		size_t kept = 0;
+		for(uint32_t position : batch.selection){
+			if(accepts(column[position]))
+				batch.selection[kept++] = position;
+		}
+		batch.selection.resize(kept);
+
+		if(!batch.empty()) return batch;
+	}
+}
+
+// The set of keys depends only on the right input, so it survives a reset.
+void HashSemiJoin::reset(){
+	left->reset();
+}
+
+}
@@ -0,0 +1,62 @@
+#pragma once
+#include <memory>
+#include <unordered_set>
+#include "arena.h"
+#include "operator.h"
+
+namespace ToyDBMS {
+	// Keeps the rows of the left input whose attribute value occurs (semi-join)
+	// or does not occur (anti-join) in the given attribute of the right input.
+	// The right input is read once into a hash set; the output has the header
+	// and the order of the left input. A semi-join hands a runtime filter of
+	// the set to the left input before reading it. The set lives in the query's arena.
+	class HashSemiJoin : public Operator {
+		using KeySet = std::unordered_set<Value, std::hash<Value>, std::equal_to<Value>, ArenaAllocator<Value>>;
+
+		std::unique_ptr<Operator> left, right;
+		Header::size_type left_index, right_index;
+		bool anti;
+
+		// built once and only read afterwards, so the parts of a split join share it
+		std::shared_ptr<const KeySet> keys;
+
+		public:
+			HashSemiJoin(std::unique_ptr<Operator> left, std::unique_ptr<Operator> right,
+						 std::string left_attr, std::string right_attr, bool anti)
+				: left(std::move(left)), right(std::move(right)),
+				  left_index(this->left->header().index(left_attr)),
+				  right_index(this->right->header().index(right_attr)),
+				  anti(anti) {}
+
+			const Header &header() override { return left->header(); }
+			Row next() override;
+			Batch nextBatch() override;
+			void reset() override;
+
+			// Builds the set of keys and splits the left side.
+			std::vector<std::unique_ptr<Operator>> split(size_t parts) override;
+
+			bool pushRuntimeFilter(const std::string &attribute, std::shared_ptr<const RuntimeFilter> filter) override {
+				return left->pushRuntimeFilter(attribute, std::move(filter));
+			}
+
+			std::string describe() override {
+				return "HashSemiJoin " + left->header()[left_index] + (anti ? " NOT IN " : " IN ") + right->header()[right_index];
+			}
+
+			std::vector<std::unique_ptr<Operator> *> inputs() override { return {&left, &right}; }
+			size_t memoryUsage() override { return keys ? hash_table_bytes(*keys) : 0; }
+
+		private:
+			// filters a part of the source's left input with the source's keys
+			HashSemiJoin(const HashSemiJoin &source, std::unique_ptr<Operator> left)
+				: left(std::move(left)), left_index(source.left_index), right_index(source.right_index),
+				  anti(source.anti), keys(source.keys) {}
+
+			void buildKeys();
+
+			bool accepts(const Value &value) const {
+				return (keys->find(value) == keys->end()) == anti;
+			}
+	};
+}
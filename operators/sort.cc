@@ -0,0 +1,331 @@
+#include <algorithm>
+#include <cstdio>
+#include <numeric>
+#include <stdexcept>
+#include "sort.h"
+#include "threadpool.h"
+
+namespace ToyDBMS {
+	static size_t configured_memory = size_t(64) << 20;
+
+	void Sort::configureMemory(size_t bytes) {
+		configured_memory = std::max<size_t>(1, bytes);
+	}
+
+	size_t Sort::memory() {
+		return configured_memory;
+	}
+
+	// Sorted rows stored one after another, read from the first.
+	class Sort::Run {
+		public:
+			virtual ~Run() {}
+
+			// the values of the current row, nullptr after the last one
+			virtual const Value *current() const = 0;
+			virtual void advance() = 0;
+			virtual void rewind() = 0;
+			virtual size_t memoryUsage() const = 0;
+	};
+
+	class Sort::MemoryRun : public Sort::Run {
+		std::vector<Value> values;
+		size_t width;
+		size_t position = 0;
+
+		public:
+			MemoryRun(std::vector<Value> values, size_t width)
+			: values(std::move(values)), width(width) {}
+
+			const Value *current() const override {
+				return position < values.size() ? values.data() + position : nullptr;
+			}
+
+			void advance() override { position += width; }
+			void rewind() override { position = 0; }
+			size_t memoryUsage() const override { return values.capacity() * sizeof(Value); }
+	};
+
+	// Values are written as their 16 bytes, the strings they point to stay in the arena.
+	class Sort::FileRun : public Sort::Run {
+		static constexpr size_t READ_BYTES = 64 << 10;
+
+		std::FILE *file;
+		size_t width;
+		size_t rows;
+		size_t rowsRead = 0;
+
+		std::vector<Value> buffer;
+		size_t position = 0;
+
+		void load() {
+			size_t count = std::min(std::max<size_t>(1, READ_BYTES / (width * sizeof(Value))), rows - rowsRead);
+			buffer.assign(count * width, Value(0));
+			position = 0;
+			if (count > 0 && std::fread(buffer.data(), sizeof(Value) * width, count, file) != count) {
+				throw std::runtime_error("could not read a sorted run back");
+			}
+			rowsRead += count;
+		}
+
+		public:
+			FileRun(const std::vector<Value> &values, size_t width)
+			: file(std::tmpfile()), width(width), rows(values.size() / width) {
+				if (file == nullptr) {
+					throw std::runtime_error("could not create a temporary file to sort");
+				}
+
+				if (std::fwrite(values.data(), sizeof(Value), values.size(), file) != values.size()) {
+					std::fclose(file);
+					throw std::runtime_error("could not write a sorted run");
+				}
+
+				rewind();
+			}
+
+			~FileRun() { std::fclose(file); }
+
+			const Value *current() const override {
+				return position < buffer.size() ? buffer.data() + position : nullptr;
+			}
+
+			void advance() override {
+				position += width;
+				if (position == buffer.size() && rowsRead < rows) {
+					load();
+				}
+			}
+
+			void rewind() override {
+				std::rewind(file);
+				rowsRead = 0;
+				load();
+			}
+
+			size_t memoryUsage() const override { return buffer.capacity() * sizeof(Value); }
+	};
+
+	Sort::Sort(std::unique_ptr<Operator> child, const std::vector<std::string> &attributes)
+	: child(std::move(child)), attributes(attributes), width(this->child->header().size()) {
+		for (const std::string &attribute : attributes) {
+			keys.push_back(this->child->header().index(attribute));
+		}
+	}
+
+	Sort::~Sort() {}
+
+	// Sorts the buffered rows and empties the buffer.
+	std::unique_ptr<Sort::Run> Sort::makeRun(std::vector<Value> &buffer, bool keepInMemory) {
+		size_t rows = buffer.size() / width;
+		std::vector<uint32_t> order(rows);
+		std::iota(order.begin(), order.end(), 0);
+		std::stable_sort(order.begin(), order.end(), [&](uint32_t a, uint32_t b) {
+			for (size_t key : keys) {
+				int result = buffer[a * width + key].compare(buffer[b * width + key]);
+				if (result != 0) {
+					return result < 0;
+				}
+			}
+			return false;
+		});
+
+		std::vector<Value> sorted;
+		sorted.reserve(buffer.size());
+		for (uint32_t row : order) {
+			sorted.insert(sorted.end(), buffer.begin() + row * width, buffer.begin() + (row + 1) * width);
+		}
+		buffer.clear();
+
+		if (keepInMemory) {
+			return std::unique_ptr<Run>(new MemoryRun(std::move(sorted), width));
+		}
+
+		spilled++;
+		return std::unique_ptr<Run>(new FileRun(sorted, width));
+	}
+
+	// Sorts what the input produces into runs of at most bufferLimit bytes. The
+	// last run stays in memory if the budget of the sort allows it.
+	void Sort::sortPart(Operator &input, std::vector<std::unique_ptr<Run>> &partRuns, size_t bufferLimit) {
+		std::vector<Value> buffer;
+		for (Batch batch = input.nextBatch(); !batch.empty(); batch = input.nextBatch()) {
+			for (uint32_t position : batch.selection) {
+				for (const std::vector<Value> &column : batch.columns) {
+					buffer.push_back(column[position]);
+				}
+
+				if (buffer.size() * sizeof(Value) >= bufferLimit) {
+					partRuns.push_back(makeRun(buffer, false));
+				}
+			}
+		}
+
+		if (buffer.empty()) {
+			return;
+		}
+
+		size_t bytes = buffer.size() * sizeof(Value);
+		bool keep = resident.fetch_add(bytes) + bytes <= memory();
+		if (!keep) {
+			resident -= bytes;
+		}
+		partRuns.push_back(makeRun(buffer, keep));
+	}
+
+	void Sort::start() {
+		started = true;
+
+		std::vector<std::unique_ptr<Operator>> parts;
+		if (ThreadPool::threads() > 1) {
+			parts = child->split(ThreadPool::morsels());
+		}
+
+		if (parts.empty()) {
+			sortPart(*child, runs, memory());
+		} else {
+			// every thread fills a buffer of its own
+			size_t bufferLimit = std::max<size_t>(1, memory() / ThreadPool::threads());
+			std::vector<std::vector<std::unique_ptr<Run>>> partRuns(parts.size());
+			parallel_for(parts.size(), [&](size_t i) {
+				sortPart(*parts[i], partRuns[i], bufferLimit);
+			});
+
+			for (auto &part : partRuns) {
+				for (auto &run : part) {
+					runs.push_back(std::move(run));
+				}
+			}
+		}
+
+		buildTree();
+	}
+
+	// An exhausted run is larger than any other, equal rows are taken from the
+	// earlier run first, which holds the earlier input.
+	bool Sort::less(size_t a, size_t b) const {
+		const Value *left = runs[a]->current();
+		const Value *right = runs[b]->current();
+		if (left == nullptr || right == nullptr) {
+			return right == nullptr && (left != nullptr || a < b);
+		}
+
+		for (size_t key : keys) {
+			int result = left[key].compare(right[key]);
+			if (result != 0) {
+				return result < 0;
+			}
+		}
+
+		return a < b;
+	}
+
+	// The runs are the leaves size() ... 2 * size() - 1 of a binary tree whose
+	// node i has the children 2i and 2i + 1.
+	void Sort::buildTree() {
+		size_t count = runs.size();
+		tree.assign(std::max<size_t>(count, 1), 0);
+		if (count == 0) {
+			return;
+		}
+
+		std::vector<size_t> winners(2 * count);
+		for (size_t i = 0; i < count; i++) {
+			winners[count + i] = i;
+		}
+
+		for (size_t node = count - 1; node > 0; node--) {
+			size_t a = winners[2 * node], b = winners[2 * node + 1];
+			bool aWins = less(a, b);
+			winners[node] = aWins ? a : b;
+			tree[node] = aWins ? b : a;
+		}
+
+		tree[0] = winners[1];
+	}
+
+	// Plays the matches on the way from the leaf of the run to the root again,
+	// after the run moved to its next row.
+	void Sort::replay(size_t run) {
+		size_t winner = run;
+		for (size_t node = (run + runs.size()) / 2; node > 0; node /= 2) {
+			if (less(tree[node], winner)) {
+				std::swap(tree[node], winner);
+			}
+		}
+		tree[0] = winner;
+	}
+
+	Row Sort::next() {
+		if (!started) {
+			start();
+		}
+
+		if (runs.empty()) {
+			return {};
+		}
+
+		size_t run = tree[0];
+		const Value *values = runs[run]->current();
+		if (values == nullptr) {
+			return {};
+		}
+
+		Row row(std::vector<Value>(values, values + width));
+		runs[run]->advance();
+		replay(run);
+
+		return row;
+	}
+
+	Batch Sort::nextBatch() {
+		if (!started) {
+			start();
+		}
+
+		Batch batch(width);
+		while (!runs.empty() && !batch.full()) {
+			size_t run = tree[0];
+			const Value *values = runs[run]->current();
+			if (values == nullptr) {
+				break;
+			}
+
+			for (size_t i = 0; i < width; i++) {
+				batch.columns[i].push_back(values[i]);
+			}
+			batch.commit();
+
+			runs[run]->advance();
+			replay(run);
+		}
+
+		return batch;
+	}
+
+	void Sort::reset() {
+		if (!started) {
+			return;
+		}
+
+		for (auto &run : runs) {
+			run->rewind();
+		}
+		buildTree();
+	}
+
+	std::string Sort::describe() {
+		std::string result = "Sort " + attribute_list(attributes);
+		if (spilled > 0) {
+			result += ", " + std::to_string(spilled) + " runs spilled";
+		}
+		return result;
+	}
+
+	size_t Sort::memoryUsage() {
+		size_t result = 0;
+		for (auto &run : runs) {
+			result += run->memoryUsage();
+		}
+		return result;
+	}
+}
@@ -0,0 +1,60 @@
+#pragma once
+#include <atomic>
+#include "operator.h"
+
+namespace ToyDBMS {
+	// Sorts its input in ascending order of the given attributes, rows with
+	// equal keys stay in input order. The input is sorted in memory within the
+	// configured budget; beyond it sorted runs are spilled to temporary files.
+	// The runs are merged with a loser tree as the output is read, and a reset
+	// merges them again without reading the input. Spilled values refer to
+	// strings in the query's arena, so the files live only as long as the query.
+	// With several threads every part of the split input is sorted on its own
+	// and the runs of all parts are merged.
+	class Sort : public Operator {
+		class Run;
+		class MemoryRun;
+		class FileRun;
+
+		std::unique_ptr<Operator> child;
+		std::vector<std::string> attributes;
+		std::vector<size_t> keys;
+		size_t width;
+
+		bool started = false;
+		std::vector<std::unique_ptr<Run>> runs;
+		std::atomic<size_t> resident {0}; // bytes of the runs kept in memory
+		std::atomic<size_t> spilled {0};  // number of runs written to files
+
+		// tree[0] is the run with the smallest row, the other nodes hold the
+		// runs that lost the match played there
+		std::vector<size_t> tree;
+
+		public:
+			Sort(std::unique_ptr<Operator> child, const std::vector<std::string> &attributes);
+			~Sort();
+
+			const Header &header() override { return child->header(); }
+			Row next() override;
+			Batch nextBatch() override;
+			void reset() override;
+
+			std::string describe() override;
+			std::vector<std::unique_ptr<Operator> *> inputs() override { return {&child}; }
+			size_t memoryUsage() override;
+
+			// Bytes of rows a sort holds in memory before it spills, 64 MB by
+			// default. Has to be set before a query is run.
+			static void configureMemory(size_t bytes);
+			static size_t memory();
+
+		private:
+			void start();
+			void sortPart(Operator &input, std::vector<std::unique_ptr<Run>> &partRuns, size_t bufferLimit);
+			std::unique_ptr<Run> makeRun(std::vector<Value> &buffer, bool keepInMemory);
+
+			bool less(size_t a, size_t b) const;
+			void buildTree();
+			void replay(size_t run);
+	};
+}
@@ -0,0 +1,163 @@
+#include <algorithm>
+#include <chrono>
+#include "threadpool.h"
+
+namespace ToyDBMS {
+
+static thread_local ThreadPool *current_pool = nullptr;
+static thread_local size_t current_queue = 0;
+
+static size_t configured_threads = 1;
+
+ThreadPool::ThreadPool(size_t threads){
+    threads = std::max<size_t>(1, threads);
+    for(size_t i = 0; i < threads; i++)
+        queues.push_back(std::make_unique<Queue>());
+    for(size_t i = 0; i < threads; i++)
+        workers.emplace_back(&ThreadPool::work, this, i);
+}
+
+ThreadPool::~ThreadPool(){
+    {
+        std::lock_guard<std::mutex> lock(sleep_mutex);
+        stopping = true;
+    }
+    wake_up.notify_all();
+    for(std::thread &worker : workers)
+        worker.join();
+}
+
+void ThreadPool::submit(Task task){
+    // a worker keeps the tasks it creates, so their data is likely still in its cache
+    size_t index = current_pool == this ? current_queue : next_queue++ % queues.size();
+    {
+        std::lock_guard<std::mutex> lock(queues[index]->mutex);
+        queues[index]->tasks.push_back(std::move(task));
+    }
+
+    pending++;
+    {
+        std::lock_guard<std::mutex> lock(sleep_mutex);
+    }
+    wake_up.notify_one();
+}
+
+bool ThreadPool::take(size_t index, Task &task){
+    {
+        Queue &own = *queues[index];
+        std::lock_guard<std::mutex> lock(own.mutex);
+        if(!own.tasks.empty()){
+            task = std::move(own.tasks.back());
+            own.tasks.pop_back();
+            pending--;
+            return true;
+        }
+    }
+
+    for(size_t i = 1; i < queues.size(); i++){
+        Queue &victim = *queues[(index + i) % queues.size()];
+        std::lock_guard<std::mutex> lock(victim.mutex);
+        if(!victim.tasks.empty()){
+            task = std::move(victim.tasks.front());
+            victim.tasks.pop_front();
+            pending--;
+            return true;
+        }
+    }
+
+    return false;
+}
+
+bool ThreadPool::runPendingTask(){
+    Task task;
+    if(!take(current_pool == this ? current_queue : 0, task)) return false;
+    task();
+    return true;
+}
+
+void ThreadPool::work(size_t index){
+    current_pool = this;
+    current_queue = index;
+
+    while(true){
+        Task task;
+        if(take(index, task)){
+            task();
+            continue;
+        }
+
+        std::unique_lock<std::mutex> lock(sleep_mutex);
+        wake_up.wait(lock, [this]{ return stopping || pending > 0; });
+        if(stopping && pending == 0) return;
+    }
+}
+
+void ThreadPool::configure(size_t threads){
+    configured_threads = std::max<size_t>(1, threads);
+}
+
+size_t ThreadPool::threads(){
+    return configured_threads;
+}
+
+// The thread that waits for the results helps running the tasks,
+// so one thread less is started.
+ThreadPool &ThreadPool::global(){
+    static ThreadPool pool(threads() - 1);
+    return pool;
+}
+
+TaskGroup::~TaskGroup(){
+    try {
+        wait();
+    } catch(...){}
+}
+
+void TaskGroup::run(ThreadPool::Task task){
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        remaining++;
+    }
+
+    pool.submit([this, task]{
+        std::exception_ptr thrown;
+        try {
+            task();
+        } catch(...){
+            thrown = std::current_exception();
+        }
+
+        std::lock_guard<std::mutex> lock(mutex);
+        if(thrown && !error) error = thrown;
+        if(--remaining == 0) finished.notify_all();
+    });
+}
+
+void TaskGroup::wait(){
+    while(true){
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            if(remaining == 0) break;
+        }
+
+        if(!pool.runPendingTask()){
+            std::unique_lock<std::mutex> lock(mutex);
+            finished.wait_for(lock, std::chrono::milliseconds(1), [this]{ return remaining == 0; });
+        }
+    }
+
+    if(error){
+        std::exception_ptr thrown = error;
+        error = nullptr;
+        std::rethrow_exception(thrown);
+    }
+}
+
+void parallel_for(size_t count, const std::function<void(size_t)> &body){
+    TaskGroup group;
+    for(size_t i = 0; i < count; i++)
+        group.run([&body, i]{ body(i); });
+    group.wait();
+}
+
+}
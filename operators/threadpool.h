@@ -0,0 +1,83 @@
+#pragma once
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace ToyDBMS {
+
+// Fixed set of worker threads, each with its own task deque. A worker takes
+// the newest task of its own deque and steals the oldest task of another
+// deque when its own is empty. Threads waiting for tasks help run them.
+class ThreadPool {
+public:
+    using Task = std::function<void()>;
+
+    ThreadPool(size_t threads);
+    ~ThreadPool();
+
+    ThreadPool(const ThreadPool &) = delete;
+    ThreadPool &operator=(const ThreadPool &) = delete;
+
+    void submit(Task task);
+
+    // Runs one queued task on the calling thread. Returns false if there was none.
+    bool runPendingTask();
+
+    // Number of threads queries are executed with, 1 by default.
+    // Has to be set before the first use of the global pool.
+    static void configure(size_t threads);
+    static size_t threads();
+
+    // Number of morsels a parallel operator splits its input into. Small
+    // morsels balance the load and bound what an ordered consumer buffers.
+    static size_t morsels() { return threads() * 16; }
+
+    static ThreadPool &global();
+
+private:
+    struct Queue {
+        std::mutex mutex;
+        std::deque<Task> tasks;
+    };
+
+    std::vector<std::unique_ptr<Queue>> queues;
+    std::vector<std::thread> workers;
+
+    std::mutex sleep_mutex;
+    std::condition_variable wake_up;
+    std::atomic<size_t> pending {0};
+    std::atomic<size_t> next_queue {0};
+    bool stopping = false;
+
+    void work(size_t index);
+    bool take(size_t index, Task &task);
+};
+
+// Tasks submitted together that can be waited for. The first exception thrown
+// by a task is rethrown by wait().
+class TaskGroup {
+    ThreadPool &pool;
+
+    std::mutex mutex;
+    std::condition_variable finished;
+    size_t remaining = 0;
+    std::exception_ptr error;
+
+public:
+    TaskGroup(ThreadPool &pool = ThreadPool::global()): pool(pool) {}
+    ~TaskGroup();
+
+    void run(ThreadPool::Task task);
+    void wait();
+};
+
+// Runs body(i) for every i in [0, count) on the global pool and waits for all of them.
+void parallel_for(size_t count, const std::function<void(size_t)> &body);
+
+}
@@ -0,0 +1,184 @@
+#include <algorithm>
+#include "topn.h"
+#include "threadpool.h"
+
+namespace ToyDBMS {
+	// The kept rows in slots of `width` values. The entries form a max-heap,
+	// so the row that would be dropped first is on top.
+	class TopN::Heap {
+		public:
+			struct Entry {
+				size_t slot;
+				size_t sequence; // position of the row in the input of the heap
+			};
+
+			std::vector<Value> values;
+			std::vector<Entry> entries;
+
+		private:
+			const std::vector<size_t> &keys;
+			size_t width;
+			size_t limit;
+			size_t sequence = 0;
+
+		public:
+			Heap(const std::vector<size_t> &keys, size_t width, size_t limit)
+			: keys(keys), width(width), limit(limit) {}
+
+			const Value *row(const Entry &entry) const {
+				return values.data() + entry.slot * width;
+			}
+
+			// Orders the rows by their keys, equal ones by their position.
+			bool before(const Entry &a, const Entry &b) const {
+				const Value *left = row(a), *right = row(b);
+				for (size_t key : keys) {
+					int result = left[key].compare(right[key]);
+					if (result != 0) {
+						return result < 0;
+					}
+				}
+				return a.sequence < b.sequence;
+			}
+
+			void offer(const Batch &batch, uint32_t position) {
+				auto order = [this](const Entry &a, const Entry &b) { return before(a, b); };
+				size_t current = sequence++;
+
+				if (entries.size() < limit) {
+					for (const std::vector<Value> &column : batch.columns) {
+						values.push_back(column[position]);
+					}
+					entries.push_back({entries.size(), current});
+					std::push_heap(entries.begin(), entries.end(), order);
+					return;
+				}
+
+				// a row equal to the top came later, so it is dropped as well
+				const Value *top = row(entries.front());
+				int result = 0;
+				for (size_t key : keys) {
+					result = batch.columns[key][position].compare(top[key]);
+					if (result != 0) {
+						break;
+					}
+				}
+				if (result >= 0) {
+					return;
+				}
+
+				std::pop_heap(entries.begin(), entries.end(), order);
+				Entry &replaced = entries.back();
+				for (size_t i = 0; i < width; i++) {
+					values[replaced.slot * width + i] = batch.columns[i][position];
+				}
+				replaced.sequence = current;
+				std::push_heap(entries.begin(), entries.end(), order);
+			}
+	};
+
+	TopN::TopN(std::unique_ptr<Operator> child, const std::vector<std::string> &attributes, size_t limit)
+	: child(std::move(child)), attributes(attributes), width(this->child->header().size()), limit(limit) {
+		for (const std::string &attribute : attributes) {
+			keys.push_back(this->child->header().index(attribute));
+		}
+	}
+
+	TopN::~TopN() {}
+
+	void TopN::select(Operator &input, Heap &heap) {
+		for (Batch batch = input.nextBatch(); !batch.empty(); batch = input.nextBatch()) {
+			for (uint32_t position : batch.selection) {
+				heap.offer(batch, position);
+			}
+		}
+	}
+
+	// The parts of the split input follow each other, so among equal rows the
+	// ones of an earlier part come first.
+	void TopN::start() {
+		started = true;
+		if (limit == 0) {
+			return;
+		}
+
+		std::vector<std::unique_ptr<Operator>> parts;
+		if (ThreadPool::threads() > 1) {
+			parts = child->split(ThreadPool::morsels());
+		}
+
+		std::vector<Heap> heaps(std::max<size_t>(parts.size(), 1), Heap(keys, width, limit));
+		if (parts.empty()) {
+			select(*child, heaps[0]);
+		} else {
+			parallel_for(parts.size(), [&](size_t i) {
+				select(*parts[i], heaps[i]);
+			});
+		}
+
+		std::vector<std::pair<size_t, Heap::Entry>> candidates;
+		for (size_t i = 0; i < heaps.size(); i++) {
+			for (const Heap::Entry &entry : heaps[i].entries) {
+				candidates.emplace_back(i, entry);
+			}
+		}
+
+		std::sort(candidates.begin(), candidates.end(), [&](const std::pair<size_t, Heap::Entry> &a, const std::pair<size_t, Heap::Entry> &b) {
+			if (a.first == b.first) {
+				return heaps[a.first].before(a.second, b.second);
+			}
+
+			const Value *left = heaps[a.first].row(a.second), *right = heaps[b.first].row(b.second);
+			for (size_t key : keys) {
+				int result = left[key].compare(right[key]);
+				if (result != 0) {
+					return result < 0;
+				}
+			}
+			return a.first < b.first;
+		});
+
+		candidates.resize(std::min(candidates.size(), limit));
+		rows.reserve(candidates.size() * width);
+		for (const auto &candidate : candidates) {
+			const Value *values = heaps[candidate.first].row(candidate.second);
+			rows.insert(rows.end(), values, values + width);
+		}
+	}
+
+	Row TopN::next() {
+		if (!started) {
+			start();
+		}
+
+		if (position == rows.size()) {
+			return {};
+		}
+
+		auto begin = rows.begin() + position;
+		position += width;
+
+		return Row(std::vector<Value>(begin, begin + width));
+	}
+
+	Batch TopN::nextBatch() {
+		if (!started) {
+			start();
+		}
+
+		Batch batch(width);
+		while (!batch.full() && position < rows.size()) {
+			for (size_t i = 0; i < width; i++) {
+				batch.columns[i].push_back(rows[position + i]);
+			}
+			batch.commit();
+			position += width;
+		}
+
+		return batch;
+	}
+
+	std::string TopN::describe() {
+		return "TopN " + std::to_string(limit) + " by " + attribute_list(attributes);
+	}
+}
@@ -0,0 +1,41 @@
+#pragma once
+#include "operator.h"
+
+namespace ToyDBMS {
+	// Returns the first rows of its input in ascending order of the given
+	// attributes, as a Sort followed by a Limit would, while holding no more
+	// than that many rows: a bounded heap keeps the smallest rows seen so far,
+	// and a row that would not make it into the heap is not copied. Rows with
+	// equal keys keep their input order. With several threads every part of
+	// the split input fills a heap of its own and the heaps are merged.
+	class TopN : public Operator {
+		class Heap;
+
+		std::unique_ptr<Operator> child;
+		std::vector<std::string> attributes;
+		std::vector<size_t> keys;
+		size_t width;
+		size_t limit;
+
+		bool started = false;
+		std::vector<Value> rows; // the result, `width` values per row
+		size_t position = 0;
+
+		public:
+			TopN(std::unique_ptr<Operator> child, const std::vector<std::string> &attributes, size_t limit);
+			~TopN();
+
+			const Header &header() override { return child->header(); }
+			Row next() override;
+			Batch nextBatch() override;
+			void reset() override { position = 0; }
+
+			std::string describe() override;
+			std::vector<std::unique_ptr<Operator> *> inputs() override { return {&child}; }
+			size_t memoryUsage() override { return rows.capacity() * sizeof(Value); }
+
+		private:
+			void start();
+			void select(Operator &input, Heap &heap);
+	};
+}
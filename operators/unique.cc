@@ -1,19 +1,104 @@
 #include <algorithm>
 #include <iterator>
 #include "unique.h"
+#include "threadpool.h"
 
 namespace ToyDBMS {
+	// Every part of the split input is deduplicated on its own, then the parts
+	// are merged in input order, so the first occurrence of every row is kept
+	// exactly as in the single-threaded case.
+	void Unique::start() {
+		started = true;
+		if (ThreadPool::threads() == 1) {
+			return;
+		}
+
+		std::vector<std::unique_ptr<Operator>> parts = child->split(ThreadPool::morsels());
+		if (parts.empty()) {
+			return;
+		}
+
+		parallel = true;
+		size_t width = header().size();
+		std::vector<DistinctSet> partSets(parts.size(), DistinctSet(width));
+		parallel_for(parts.size(), [&](size_t i) {
+			for (Batch batch = parts[i]->nextBatch(); !batch.empty(); batch = parts[i]->nextBatch()) {
+				for (uint32_t position : batch.selection) {
+					partSets[i].insert([&](size_t column) -> const Value & { return batch.columns[column][position]; });
+				}
+			}
+		});
+
+		for (const DistinctSet &part : partSets) {
+			for (size_t i = 0; i < part.size(); i++) {
+				const Value *values = part.key(i);
+				seen.insert([values](size_t column) -> const Value & { return values[column]; });
+			}
+		}
+	}
+
 	Row Unique::next() {
+		if (!started) {
+			start();
+		}
+
+		if (parallel) {
+			if (position == seen.size()) {
+				return {};
+			}
+
+			const Value *values = seen.key(position++);
+			return Row(std::vector<Value>(values, values + header().size()));
+		}
+
 		while (true) {
 			Row r = child->next();
 			if (!r) {
 				return {};
 			}
 
-			if (hashTable.find(r) == hashTable.end()) {
-				hashTable.insert(r);
+			if (seen.insert([&r](size_t column) -> const Value & { return r.values[column]; })) {
 				return r;
 			}
 		}
 	}
+
+	Batch Unique::nextBatch() {
+		if (!started) {
+			start();
+		}
+
+		if (parallel) {
+			size_t width = header().size();
+			Batch batch(width);
+			while (!batch.full() && position < seen.size()) {
+				const Value *values = seen.key(position++);
+				for (size_t i = 0; i < width; i++) {
+					batch.columns[i].push_back(values[i]);
+				}
+				batch.commit();
+			}
+
+			return batch;
+		}
+
+		while (true) {
+			Batch batch = child->nextBatch();
+			if (batch.empty()) {
+				return batch;
+			}
+
+			size_t kept = 0;
+			for (uint32_t position : batch.selection) {
+				if (seen.insert([&](size_t column) -> const Value & { return batch.columns[column][position]; })) {
+					batch.selection[kept++] = position;
+				}
+			}
+			batch.selection.resize(kept);
+
+			if (!batch.empty()) {
+				return batch;
+			}
+		}
+	}
 }
@@ -1,25 +1,44 @@
 #pragma once
+#include "distinctset.h"
 #include "operator.h"
 #include "../parser/query.h"
 
-#include <unordered_set>
-
 namespace ToyDBMS {
 	class Unique : public Operator {
 		std::unique_ptr<Operator> child;
-		std::unordered_set<Row, RowHasher> hashTable;
+		DistinctSet seen;
+
+		// With several threads the input is deduplicated up front, and the
+		// distinct rows are served from the set in input order.
+		bool started = false;
+		bool parallel = false;
+		size_t position = 0;
 
 		public:
 			Unique(std::unique_ptr<Operator> child)
-			: child(std::move(child)) {}
+			: child(std::move(child)), seen(this->child->header().size()) {}
 
 			const Header &header() { return child->header(); }
 
 			Row next() override;
+			Batch nextBatch() override;
+
+			std::string describe() override { return "Unique"; }
+			std::vector<std::unique_ptr<Operator> *> inputs() override { return {&child}; }
+
+			size_t memoryUsage() override { return seen.memoryUsage(); }
 
 			void reset() override {
+				if (parallel) {
+					position = 0;
+					return;
+				}
+
 				child->reset();
-				hashTable.clear();
+				seen.clear();
 			}
+
+		private:
+			void start();
 	};
 }
@@ -53,10 +53,13 @@
 %token WHERE
 %token GROUPBY
 %token ORDERBY
+%token LIMIT
 %token AND
 %token OR
 %token IN
 %token NOTIN
+%token EXPLAIN
+%token ANALYZE
 
 %token GR
 %token EQ
@@ -65,7 +68,8 @@
 %left AND OR
 
 %type <bool> distinct
-%type <std::unique_ptr<Query>> query basicquery
+%type <int> limit
+%type <std::unique_ptr<Query>> query clauses basicquery
 %type <std::unique_ptr<Predicate>> whparams predicate
 %type <std::vector<std::string>> attrlist
 %type <Predicate::Relation> relation
@@ -79,24 +83,37 @@
 
 %%
 
-whole_query: query { result_query = std::move(*$1); }
+whole_query:
+    query { result_query = std::move(*$1); }
+    | EXPLAIN query { result_query = std::move(*$2); result_query.explain = Query::Explain::PLAN; }
+    | EXPLAIN ANALYZE query { result_query = std::move(*$3); result_query.explain = Query::Explain::ANALYZE; }
+    ;
 
 query:
-    basicquery WHERE whparams GROUPBY attrlist ORDERBY attrlist ';'
+    clauses limit ';' { $1->limit = $2; $$ = std::move($1); }
+    ;
+
+clauses:
+    basicquery WHERE whparams GROUPBY attrlist ORDERBY attrlist
     { $1->where = std::move($3); $1->groupby = std::move($5); $1->orderby = std::move($7); $$ = std::move($1); }
-    | basicquery WHERE whparams ORDERBY attrlist ';'
+    | basicquery WHERE whparams ORDERBY attrlist
     { $1->where = std::move($3); $1->orderby = std::move($5); $$ = std::move($1); }
-    | basicquery WHERE whparams GROUPBY attrlist ';'
+    | basicquery WHERE whparams GROUPBY attrlist
     { $1->where = std::move($3); $1->groupby = std::move($5); $$ = std::move($1); }
-    | basicquery GROUPBY attrlist ORDERBY attrlist ';'
+    | basicquery GROUPBY attrlist ORDERBY attrlist
+    { $1->groupby = std::move($3); $1->orderby = std::move($5); $$ = std::move($1); }
+    | basicquery GROUPBY attrlist
     { $1->groupby = std::move($3); $$ = std::move($1); }
-    | basicquery GROUPBY attrlist ';'
-    { $1->groupby = std::move($3); $$ = std::move($1); }
-    | basicquery ORDERBY attrlist ';'
+    | basicquery ORDERBY attrlist
     { $1->orderby = std::move($3); $$ = std::move($1); }
-    | basicquery WHERE whparams ';'
+    | basicquery WHERE whparams
     { $1->where = std::move($3); $$ = std::move($1); }
-    | basicquery ';' { $$ = std::move($1); }
+    | basicquery { $$ = std::move($1); }
+    ;
+
+limit:
+    %empty { $$ = -1; }
+    | LIMIT INT { $$ = $2; }
     ;
 
 basicquery:
@@ -149,7 +166,10 @@ frparam:
 
 attrlist:
     ATTRNAME { $$ = {$1}; }
-    | ATTRNAME ',' attrlist {$$ = std::move($3); $$.push_back(std::move($1)); }
+    | ATTRNAME ',' attrlist {
+        $$.push_back(std::move($1));
+        $$.insert($$.end(), std::make_move_iterator($3.begin()), std::make_move_iterator($3.end()));
+    }
     ;
 
 whparams:
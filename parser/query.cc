@@ -10,6 +10,20 @@
 
 namespace ToyDBMS {
 
+template<typename Accept>
+static void refine(Batch &batch, Accept accept){
+    size_t kept = 0;
+    for(uint32_t position : batch.selection)
+        if(accept(position)) batch.selection[kept++] = position;
+    batch.selection.resize(kept);
+}
+
+void Predicate::select(const Header &header, Batch &batch){
+    refine(batch, [&](uint32_t position){
+        return check(Row(batch.values(position)));
+    });
+}
+
 void ConstPredicate::print(){
     std::cout << attribute;
     switch(relation){
@@ -26,8 +40,31 @@ void ConstPredicate::print(){
     std::cout << value << '\n';
 }
 
+static const char *relation_symbol(Predicate::Relation relation){
+    switch(relation){
+    case Predicate::Relation::GREATER: return " > ";
+    case Predicate::Relation::EQUAL:   return " = ";
+    case Predicate::Relation::LESS:    return " < ";
+    default: throw std::runtime_error("unknown relation");
+    }
+}
+
+std::string ConstPredicate::describe(){
+    std::ostringstream os;
+    os << attribute << relation_symbol(relation);
+    if(value.type == Value::Type::STR) os << '"' << value << '"';
+    else os << value;
+    return os.str();
+}
+
+void ConstPredicate::bind(const Header &header){
+    index = header.index(attribute);
+    bound = true;
+}
+
 bool ConstPredicate::check(const Row &row){
-    const Value &row_val = row[attribute];
+    if(!bound) throw std::runtime_error("predicate on " + attribute + " is checked before it is bound");
+    const Value &row_val = row[index];
     switch(relation){
     case Relation::LESS:
         return row_val <  value;
@@ -39,6 +76,19 @@ bool ConstPredicate::check(const Row &row){
     }
 }
 
+void ConstPredicate::select(const Header &header, Batch &batch){
+    const std::vector<Value> &column = batch.columns[bound ? index : header.index(attribute)];
+    switch(relation){
+    case Relation::LESS:
+        return refine(batch, [&](uint32_t position){ return column[position] <  value; });
+    case Relation::EQUAL:
+        return refine(batch, [&](uint32_t position){ return column[position] == value; });
+    case Relation::GREATER:
+        return refine(batch, [&](uint32_t position){ return column[position] >  value; });
+    default: throw std::runtime_error("unknown value type");
+    }
+}
+
 void AttributePredicate::print(){
     std::cout << left;
     switch(relation){
@@ -55,16 +105,51 @@ void AttributePredicate::print(){
     std::cout << right << '\n';
 }
 
+std::string AttributePredicate::describe(){
+    return left + relation_symbol(relation) + right;
+}
+
+void AttributePredicate::bind(const Header &header){
+    left_index = header.index(left);
+    right_index = header.index(right);
+    bound = true;
+}
+
 bool AttributePredicate::check(const Row &row){
+	if (!bound) {
+		throw std::runtime_error("predicate on " + left + " is checked before it is bound");
+	}
+
+	const Value &leftValue = row[left_index];
+	const Value &rightValue = row[right_index];
+
+	switch (relation) {
+		case Relation::LESS:
+			return leftValue < rightValue;
+
+		case Relation::EQUAL:
+			return leftValue == rightValue;
+
+		case Relation::GREATER:
+			return leftValue > rightValue;
+
+		default:
+			throw std::runtime_error("Unsupported Relation inside of AttributePredicate");
+	}
+}
+
+void AttributePredicate::select(const Header &header, Batch &batch){
+    const std::vector<Value> &leftColumn = batch.columns[bound ? left_index : header.index(left)];
+    const std::vector<Value> &rightColumn = batch.columns[bound ? right_index : header.index(right)];
 	switch (relation) {
 		case Relation::LESS:
-			return row[left] < row[right];
+			return refine(batch, [&](uint32_t p){ return leftColumn[p] < rightColumn[p]; });
 
 		case Relation::EQUAL:
-			return row[left] == row[right];
+			return refine(batch, [&](uint32_t p){ return leftColumn[p] == rightColumn[p]; });
 
 		case Relation::GREATER:
-			return row[left] > row[right];
+			return refine(batch, [&](uint32_t p){ return leftColumn[p] > rightColumn[p]; });
 
 		default:
 			throw std::runtime_error("Unsupported Relation inside of AttributePredicate");
@@ -77,10 +162,18 @@ void QueryPredicate::print(){
     std::cout << "}\n";
 }
 
+std::string QueryPredicate::describe(){
+    return attribute + (in ? " IN (subquery)" : " NOT IN (subquery)");
+}
+
 bool QueryPredicate::check(const Row &row){
     throw std::runtime_error("not implemented");
 }
 
+void QueryPredicate::bind(const Header &header){
+    throw std::runtime_error("not implemented");
+}
+
 void ANDPredicate::print(){
     std::cout << "{\n";
     left->print();
@@ -89,10 +182,24 @@ void ANDPredicate::print(){
     std::cout << "}\n";
 }
 
+std::string ANDPredicate::describe(){
+    return "(" + left->describe() + ") AND (" + right->describe() + ")";
+}
+
 bool ANDPredicate::check(const Row &row){
     return left->check(row) && right->check(row);
 }
 
+void ANDPredicate::bind(const Header &header){
+    left->bind(header);
+    right->bind(header);
+}
+
+void ANDPredicate::select(const Header &header, Batch &batch){
+    left->select(header, batch);
+    if(!batch.empty()) right->select(header, batch);
+}
+
 void ORPredicate::print(){
     std::cout << "{\n";
     left->print();
@@ -101,10 +208,19 @@ void ORPredicate::print(){
     std::cout << "}\n";
 }
 
+std::string ORPredicate::describe(){
+    return "(" + left->describe() + ") OR (" + right->describe() + ")";
+}
+
 bool ORPredicate::check(const Row &row){
     return left->check(row) || right->check(row);
 }
 
+void ORPredicate::bind(const Header &header){
+    left->bind(header);
+    right->bind(header);
+}
+
 void FromTable::print(){
     std::cout << table_name << '\n';
 }
@@ -116,6 +232,9 @@ void FromQuery::print(){
 }
 
 void Query::print(){
+    if(explain == Explain::PLAN) std::cout << "EXPLAIN\n";
+    if(explain == Explain::ANALYZE) std::cout << "EXPLAIN ANALYZE\n";
+
     std::cout << (distinct ? "DISTINCT" : "NOT DISTINCT") << '\n';
 
     std::cout << "ATTRIBUTES:\n";
@@ -159,6 +278,8 @@ void Query::print(){
         std::cout << "ORDERBY:\n";
         for(auto &attr : orderby) std::cout << attr << '\n';
     }
+
+    if(limit >= 0) std::cout << "LIMIT: " << limit << '\n';
 }
 
 Query Query::parse(std::istream &stream){
@@ -5,6 +5,7 @@
 #include <vector>
 
 #include "../operators/row.h"
+#include "../operators/batch.h"
 
 namespace ToyDBMS {
     class Query;
@@ -21,6 +22,17 @@ namespace ToyDBMS {
         virtual ~Predicate(){}
         virtual void print() = 0;
         virtual bool check(const Row &row) = 0;
+
+        // The predicate on one line, in the syntax of the query language.
+        virtual std::string describe() = 0;
+
+        // Resolves the attributes the predicate reads to their slots in rows
+        // with the given header, so check() and select() do not look them up.
+        virtual void bind(const Header &header) = 0;
+
+        // Removes the tuples that do not satisfy the predicate from the selection
+        // of the batch. The default implementation checks the tuples one by one.
+        virtual void select(const Header &header, Batch &batch);
     };
 
     struct ConstPredicate : public Predicate {
@@ -28,6 +40,9 @@ namespace ToyDBMS {
         Relation relation;
         Value value;
 
+        bool bound = false;
+        Header::size_type index = 0;
+
         ConstPredicate(std::string attr, int val, Relation rel)
             : Predicate(Type::CONST), attribute(attr), relation(rel), value(val) {}
 
@@ -39,17 +54,26 @@ namespace ToyDBMS {
 
         void print() override;
         bool check(const Row &row) override;
+        std::string describe() override;
+        void bind(const Header &header) override;
+        void select(const Header &header, Batch &batch) override;
     };
 
     struct AttributePredicate : public Predicate {
         std::string left, right;
         Relation relation;
 
+        bool bound = false;
+        Header::size_type left_index = 0, right_index = 0;
+
         AttributePredicate(std::string left, std::string right, Relation rel)
             : Predicate(Type::ATTR), left(std::move(left)), right(std::move(right)), relation(rel) {}
 
         void print() override;
         bool check(const Row &row) override;
+        std::string describe() override;
+        void bind(const Header &header) override;
+        void select(const Header &header, Batch &batch) override;
     };
 
     struct QueryPredicate : public Predicate {
@@ -63,6 +87,8 @@ namespace ToyDBMS {
 
         void print() override;
         bool check(const Row &row) override;
+        std::string describe() override;
+        void bind(const Header &header) override;
     };
 
     struct ANDPredicate : public Predicate {
@@ -73,6 +99,9 @@ namespace ToyDBMS {
 
         void print() override;
         bool check(const Row &row) override;
+        std::string describe() override;
+        void bind(const Header &header) override;
+        void select(const Header &header, Batch &batch) override;
     };
 
     struct ORPredicate : public Predicate {
@@ -83,6 +112,8 @@ namespace ToyDBMS {
 
         void print() override;
         bool check(const Row &row) override;
+        std::string describe() override;
+        void bind(const Header &header) override;
     };
 
     // *** SELECTION ***
@@ -143,6 +174,10 @@ namespace ToyDBMS {
         std::unique_ptr<Predicate> where;
         std::vector<std::string> groupby;
         std::vector<std::string> orderby;
+        int limit = -1; // the number of rows to return, negative without LIMIT
+
+        enum class Explain { NONE, PLAN, ANALYZE };
+        Explain explain = Explain::NONE;
 
         void print();
         static Query parse(std::istream &stream);
@@ -50,6 +50,13 @@ Catalog::Catalog(){
             );
         } else throw std::runtime_error("wrong catalog format");
     }
+
+    for(auto &table_kv : tables){
+        for(auto &column_kv : table_kv.second.columns){
+            Column &column = column_kv.second;
+            column.histogram = Histogram::load("tables/" + table_kv.first + "." + column.name + ".hist", column.type);
+        }
+    }
 }
 
 }
@@ -1,6 +1,7 @@
 #pragma once
 #include <unordered_map>
 #include "../operators/row.h"
+#include "histogram.h"
 
 namespace ToyDBMS {
 
@@ -11,6 +12,7 @@ struct Column {
     SortOrder order;
     bool unique;
     Value min, max;
+    Histogram histogram; // empty if the table has no histogram for the column
     Column(std::string name, Value::Type type, Column::SortOrder order, bool unique, Value min, Value max)
         : name(name), type(type), order(order), unique(unique), min(min), max(max) {}
 };
@@ -52,7 +54,8 @@ struct Catalog {
     		const Table &table = table_kv.second;
     		for (const auto &column_kv : table.columns) {
     			const Column &column = column_kv.second;
-    			resultingTable.addColumn(table.name + "." + column.name, column.type, column.order, column.unique, column.min, column.max);
+    			// the subquery plan may reorder rows, so the sort order of its columns is not kept
+    			resultingTable.addColumn(table.name + "." + column.name, column.type, Column::SortOrder::UNKNOWN, column.unique, column.min, column.max);
     		}
     	}
 
@@ -1,4 +1,6 @@
 #include <algorithm>
+#include <cmath>
+#include <fstream>
 #include <functional>
 #include <iterator>
 #include <stdexcept>
@@ -7,6 +9,7 @@
 #include "constructor.h"
 
 #include "../operators/datasource.h"
+#include "../operators/columnarsource.h"
 #include "../operators/filter.h"
 #include "../operators/join.h"
 #include "../operators/projection.h"
@@ -15,6 +18,15 @@
 #include "../operators/unique.h"
 #include "../operators/OptimizedUnique.h"
 #include "../operators/cache.h"
+#include "../operators/aggregate.h"
+#include "../operators/constantrow.h"
+#include "../operators/hashjoin.h"
+#include "../operators/semijoin.h"
+#include "../operators/sort.h"
+#include "../operators/topn.h"
+#include "../operators/limit.h"
+#include "../operators/gather.h"
+#include "../operators/threadpool.h"
 
 #include "utils.h"
 #include "joins_applier.h"
@@ -27,12 +39,15 @@ struct PredicatesLists {
 	std::vector<ConstPredicate*> constFilterPredicates;
 
 	std::vector<AttributePredicate*> attributesInequalityFilterPredicates;
+
+	std::vector<QueryPredicate*> subqueryPredicates;
 };
 
 static void for_each_simple_predicate(Predicate &predicate, std::function<void(Predicate&)> action) {
     switch(predicate.type) {
 		case Predicate::Type::CONST:
 		case Predicate::Type::ATTR:
+		case Predicate::Type::INQUERY:
 			action(predicate);
 			break;
 
@@ -43,9 +58,8 @@ static void for_each_simple_predicate(Predicate &predicate, std::function<void(P
 			break;
 		}
 
-		case Predicate::Type::INQUERY:
 		case Predicate::Type::OR:
-			throw std::runtime_error("OR and INQUERY predicates are not yet supported");
+			throw std::runtime_error("OR predicates are not yet supported");
 
 		default:
 			throw std::runtime_error("encountered a predicate not yet supported");
@@ -90,12 +104,16 @@ static const PredicatesLists createPredicatesLists(const Query &query) {
 					break;
 				}
 
+				case Predicate::Type::INQUERY: {
+					lists.subqueryPredicates.push_back(&dynamic_cast<QueryPredicate&>(pred));
+					break;
+				}
+
 				case Predicate::Type::AND:
 					throw std::runtime_error("Missed AND predicate detected");
 
-				case Predicate::Type::INQUERY:
 				case Predicate::Type::OR:
-					throw std::runtime_error("OR and INQUERY predicates are not yet supported");
+					throw std::runtime_error("OR predicates are not yet supported");
 
 				default:
 					throw std::runtime_error("encountered a predicate not yet supported");
@@ -134,18 +152,202 @@ static std::vector<std::string> getTablesNames(const Query &query) {
 	return std::move(tables);
 }
 
+static bool is_aggregated(const Query &query) {
+	if (query.selection.type == ToyDBMS::SelectionClause::Type::COUNT || !query.groupby.empty()) {
+		return true;
+	}
+
+	for (const SelectionPart &attr : query.selection.attrs) {
+		if (attr.function != ToyDBMS::SelectionPart::AggregateFunction::NONE) {
+			return true;
+		}
+	}
+
+	return false;
+}
+
+// Collects the attributes the query reads outside of its subqueries, in the
+// order they are mentioned. Returns false if the query reads every attribute.
+static bool collect_referenced_attributes(const Query &query, std::vector<std::string> &attributes) {
+	if (query.selection.type == ToyDBMS::SelectionClause::Type::ALL) {
+		return false;
+	}
+
+	std::unordered_set<std::string> seen;
+	auto add = [&attributes, &seen](const std::string &attribute) {
+		if (seen.insert(attribute).second) {
+			attributes.push_back(attribute);
+		}
+	};
+
+	for (const SelectionPart &attr : query.selection.attrs) {
+		add(attr.attribute);
+	}
+
+	if (query.where != nullptr) {
+		for_each_simple_predicate(*query.where, [&add](Predicate &predicate) {
+			switch (predicate.type) {
+				case Predicate::Type::CONST:
+					add(dynamic_cast<ConstPredicate&>(predicate).attribute);
+					break;
+
+				case Predicate::Type::ATTR: {
+					const AttributePredicate &attributePredicate = dynamic_cast<AttributePredicate&>(predicate);
+					add(attributePredicate.left);
+					add(attributePredicate.right);
+					break;
+				}
+
+				case Predicate::Type::INQUERY:
+					add(dynamic_cast<QueryPredicate&>(predicate).attribute);
+					break;
+
+				default:
+					throw std::runtime_error("encountered a predicate not yet supported");
+			}
+		});
+	}
+
+	for (const std::string &attribute : query.groupby) {
+		add(attribute);
+	}
+
+	for (const std::string &attribute : query.orderby) {
+		add(attribute);
+	}
+
+	return true;
+}
+
+static void add_to_where(Query &query, std::unique_ptr<Predicate> predicate) {
+	if (query.where == nullptr) {
+		query.where = std::move(predicate);
+	} else {
+		query.where = std::make_unique<ANDPredicate>(std::move(query.where), std::move(predicate));
+	}
+}
+
+// Rewrites the subquery of a FROM part before it is constructed. The constant
+// bounds and the inequalities the outer query puts on the subquery's columns
+// are added to its WHERE, so they are applied to its tables before the joins,
+// and the columns the outer query never reads are removed from its selection.
+// Aggregated subqueries are left alone, because their columns are not columns
+// of their tables, and so are DISTINCT ones, whose duplicates depend on every column.
+static void push_down_into_subquery(const Query &query, const std::string &alias, Query &subquery) {
+	if (is_aggregated(subquery)) {
+		return;
+	}
+
+	std::string prefix = alias + ".";
+	auto isInner = [&prefix](const std::string &attribute) {
+		return attribute.compare(0, prefix.size(), prefix) == 0;
+	};
+	auto inner = [&prefix](const std::string &attribute) {
+		return attribute.substr(prefix.size());
+	};
+
+	PredicatesLists lists = createPredicatesLists(query);
+
+	// bounds that contradict each other empty the outer query anyway
+	ColumnsBounds bounds = rewrite_const_filters(lists.constFilterPredicates, lists.joinPredicates);
+	if (bounds.isValid) {
+		for (const auto &kv : bounds.columnExactValue) {
+			if (isInner(kv.first)) {
+				add_to_where(subquery, std::make_unique<ConstPredicate>(inner(kv.first), kv.second, Predicate::Relation::EQUAL));
+			}
+		}
+
+		for (const auto &kv : bounds.columnUpperBound) {
+			if (isInner(kv.first)) {
+				add_to_where(subquery, std::make_unique<ConstPredicate>(inner(kv.first), kv.second, Predicate::Relation::LESS));
+			}
+		}
+
+		for (const auto &kv : bounds.columnLowerBound) {
+			if (isInner(kv.first)) {
+				add_to_where(subquery, std::make_unique<ConstPredicate>(inner(kv.first), kv.second, Predicate::Relation::GREATER));
+			}
+		}
+	}
+
+	for (AttributePredicate *predicate : lists.attributesInequalityFilterPredicates) {
+		// the subquery supports inequalities between the columns of one of its tables only
+		if (
+			isInner(predicate->left) && isInner(predicate->right) &&
+			table_name(inner(predicate->left)) == table_name(inner(predicate->right))
+		) {
+			add_to_where(subquery, std::make_unique<AttributePredicate>(
+				inner(predicate->left), inner(predicate->right), predicate->relation
+			));
+		}
+	}
+
+	std::vector<std::string> referenced;
+	if (subquery.distinct || !collect_referenced_attributes(query, referenced)) {
+		return;
+	}
+
+	std::vector<SelectionPart> selection;
+	if (subquery.selection.type == ToyDBMS::SelectionClause::Type::LIST) {
+		std::unordered_set<std::string> referencedSet(referenced.begin(), referenced.end());
+		for (const SelectionPart &attr : subquery.selection.attrs) {
+			if (referencedSet.find(prefix + attr.attribute) != referencedSet.end()) {
+				selection.push_back(attr);
+			}
+		}
+	} else {
+		for (const std::string &attribute : referenced) {
+			if (isInner(attribute)) {
+				selection.push_back(SelectionPart {ToyDBMS::SelectionPart::AggregateFunction::NONE, inner(attribute)});
+			}
+		}
+	}
+
+	// a selection can't be empty, so a subquery whose columns are all unused keeps one of them
+	if (selection.empty() && subquery.selection.type == ToyDBMS::SelectionClause::Type::LIST) {
+		selection.push_back(subquery.selection.attrs.front());
+	}
+
+	if (!selection.empty()) {
+		subquery.selection.type = ToyDBMS::SelectionClause::Type::LIST;
+		subquery.selection.attrs = std::move(selection);
+	}
+}
+
 std::unordered_map<std::string, std::unique_ptr<Operator>> ConstructedQuery::processQueryOperators(
 	const Query &query
 ) {
 	std::unordered_map<std::string, std::unique_ptr<Operator>> tables(query.from.size());
 
+	// scans produce only the columns the query reads
+	std::vector<std::string> referenced;
+	bool readsEveryColumn = !collect_referenced_attributes(query, referenced);
+	std::unordered_set<std::string> columns(referenced.begin(), referenced.end());
+
 	for (const std::unique_ptr<FromPart> &fromPart : query.from) {
 		switch (fromPart->type) {
 			case FromPart::Type::TABLE: {
 				FromTable& fromTable = dynamic_cast<FromTable&>(*fromPart);
 
 				std::string table_name = fromTable.table_name;
-				tables[table_name] = std::make_unique<DataSource>("tables/" + table_name + ".csv");
+				std::string columnarFile = "tables/" + table_name + ".col";
+
+				if (std::ifstream(columnarFile).good()) {
+					tables[table_name] = readsEveryColumn
+						? std::make_unique<ColumnarSource>(columnarFile)
+						: std::make_unique<ColumnarSource>(columnarFile, columns);
+				} else {
+					std::string csvFile = "tables/" + table_name + ".csv";
+					tables[table_name] = readsEveryColumn
+						? std::make_unique<DataSource>(csvFile)
+						: std::make_unique<DataSource>(csvFile, columns);
+				}
+
+				auto table = catalog.tables.find(table_name);
+				if (table != catalog.tables.end()) {
+					tables[table_name]->setEstimatedRows(table->second.rows);
+				}
+
 				break;
 			}
 
@@ -153,6 +355,7 @@ std::unordered_map<std::string, std::unique_ptr<Operator>> ConstructedQuery::pro
 				FromQuery& fromQuery = dynamic_cast<FromQuery&>(*fromPart);
 
 				std::string alias = fromQuery.alias;
+				push_down_into_subquery(query, alias, *fromQuery.query);
 				ConstructedQuery constructedQuery(*fromQuery.query);
 
 				tables[alias] = std::make_unique<AliasAppender>(
@@ -227,11 +430,48 @@ static void make_every_table_empty(std::unordered_map<std::string, std::unique_p
 	}
 }
 
+// Fraction of the rows of the column that satisfy the predicate. Histograms are
+// used when available, otherwise values are assumed to be spread uniformly between
+// the minimum and the maximum of the column.
+static double estimate_selectivity(const Column &column, const ConstPredicate &predicate) {
+	const Histogram &histogram = column.histogram;
+	double elements = histogram.num_elements();
+
+	if (elements > 0) {
+		switch (predicate.relation) {
+			case Predicate::Relation::LESS:
+				return histogram.estimate_less(predicate.value) / elements;
+
+			case Predicate::Relation::EQUAL:
+				return histogram.estimate_equal(predicate.value) / elements;
+
+			case Predicate::Relation::GREATER:
+				return histogram.estimate_greater(predicate.value) / elements;
+
+			default:
+				throw std::runtime_error("Unsupported Relation inside of ConstPredicate");
+		}
+	}
+
+	if (predicate.relation == Predicate::Relation::EQUAL) {
+		return 0.1;
+	}
+
+	if (column.type != Value::Type::INT) {
+		return 1.0 / 3;
+	}
+
+	double width = double(column.max.intval()) - column.min.intval() + 1;
+	double below = (double(predicate.value.intval()) - column.min.intval()) / width;
+	return predicate.relation == Predicate::Relation::LESS ? below : 1 - below - 1 / width;
+}
+
 void ConstructedQuery::apply_const_filters(
 	std::unordered_map<std::string, std::unique_ptr<Operator>> &tables,
-	const std::vector<ConstPredicate*> &constFilterPredicates
+	const std::vector<ConstPredicate*> &constFilterPredicates,
+	const std::vector<AttributePredicate*> &joinPredicates
 ) {
-	ColumnsBounds bounds = rewrite_const_filters(constFilterPredicates);
+	ColumnsBounds bounds = rewrite_const_filters(constFilterPredicates, joinPredicates);
 	if (!bounds.isValid) {
 		make_every_table_empty(tables);
 		return;
@@ -283,7 +523,35 @@ void ConstructedQuery::apply_const_filters(
 		));
 	}
 
+	std::vector<double> selectivities;
 	for (const std::unique_ptr<ConstPredicate> &predicate : resultingConstFilterPredicates) {
+		const Column &column = catalog.getColumn(predicate->attribute);
+		double selectivity = estimate_selectivity(column, *predicate);
+
+		// histogram buckets cover every value of the column, so a value outside of them does not occur
+		if (
+			predicate->relation == Predicate::Relation::EQUAL &&
+			!column.histogram.empty() && selectivity == 0
+		) {
+			make_every_table_empty(tables);
+			return;
+		}
+
+		selectivities.push_back(selectivity);
+	}
+
+	// the most selective filter of a table is applied first
+	std::vector<size_t> order(resultingConstFilterPredicates.size());
+	for (size_t i = 0; i < order.size(); i++) {
+		order[i] = i;
+	}
+
+	std::stable_sort(order.begin(), order.end(), [&selectivities](size_t a, size_t b) {
+		return selectivities[a] < selectivities[b];
+	});
+
+	for (size_t i : order) {
+		const std::unique_ptr<ConstPredicate> &predicate = resultingConstFilterPredicates[i];
 		std::string tableName = table_name(predicate->attribute);
 		std::unique_ptr<Predicate> predicateCopy = std::make_unique<ConstPredicate>(*predicate);
 
@@ -295,6 +563,12 @@ void ConstructedQuery::apply_const_filters(
 		tables[tableName] = std::make_unique<Filter>(
 			std::move(tables[tableName]), std::move(predicateCopy)
 		);
+
+		// the catalog of a query describes its tables after filtering,
+		// so join ordering sees the estimated sizes of the filtered tables
+		Table &table = catalog.tables.at(tableName);
+		table.rows = static_cast<size_t>(std::ceil(table.rows * selectivities[i]));
+		tables[tableName]->setEstimatedRows(table.rows);
 	}
 }
 
@@ -325,6 +599,74 @@ void ConstructedQuery::apply_attribute_inequality_filters(
 	}
 }
 
+static bool is_unique_in_catalog(const Catalog &catalog, const std::string &attribute) {
+	auto table = catalog.tables.find(table_name(attribute));
+	if (table == catalog.tables.end()) {
+		return false;
+	}
+
+	auto column = table->second.columns.find(attribute.substr(attribute.find('.') + 1));
+	return column != table->second.columns.end() && column->second.unique;
+}
+
+void ConstructedQuery::apply_subquery_filters(
+	std::unordered_map<std::string, std::unique_ptr<Operator>> &tables,
+	const std::vector<QueryPredicate*> &subqueryPredicates
+) {
+	for (QueryPredicate *predicate : subqueryPredicates) {
+		std::string tableName = table_name(predicate->attribute);
+
+		auto it = tables.find(tableName);
+		if (it == tables.end()) {
+			throw std::runtime_error("Unknown table: " + tableName);
+		}
+
+		const Query &subquery = *predicate->query;
+		ConstructedQuery constructedQuery(subquery);
+		std::unique_ptr<Operator> subqueryOperator = constructedQuery.takeOperator();
+
+		if (subqueryOperator->header().size() != 1) {
+			throw std::runtime_error("IN subquery must select exactly one attribute");
+		}
+
+		std::string innerAttribute = subqueryOperator->header()[0];
+
+		// values of a unique column of a single table or of a DISTINCT result occur
+		// at most once, so every outer row matches at most one inner row
+		bool innerIsUnique = subquery.distinct || (
+			subquery.from.size() == 1 && subquery.from[0]->type == FromPart::Type::TABLE
+			&& is_unique_in_catalog(constructedQuery.getCatalog(), innerAttribute)
+		);
+
+		if (predicate->in && innerIsUnique) {
+			Header header = it->second->header();
+			std::unique_ptr<Operator> join = std::make_unique<HashJoin>(
+				std::move(it->second), std::move(subqueryOperator),
+				predicate->attribute, innerAttribute, HashJoin::BuildSide::RIGHT
+			);
+
+			it->second = std::make_unique<Projection>(std::move(join), std::move(header));
+		} else {
+			it->second = std::make_unique<HashSemiJoin>(
+				std::move(it->second), std::move(subqueryOperator),
+				predicate->attribute, innerAttribute, !predicate->in
+			);
+		}
+	}
+}
+
+// With several threads every table is scanned and filtered by morsels in
+// parallel and handed to the joins in file order.
+static void load_tables_in_parallel(std::unordered_map<std::string, std::unique_ptr<Operator>> &tables) {
+	if (ThreadPool::threads() == 1) {
+		return;
+	}
+
+	for (auto &kv : tables) {
+		kv.second = std::make_unique<Gather>(std::move(kv.second), true);
+	}
+}
+
 std::unordered_set<std::string> ConstructedQuery::getAttributesInResult(const Query &query) {
 	std::unordered_set<std::string> attributesInProjection;
 
@@ -341,16 +683,15 @@ std::unordered_set<std::string> ConstructedQuery::getAttributesInResult(const Qu
 
 		case ToyDBMS::SelectionClause::Type::LIST: {
 			for (const SelectionPart &attr : query.selection.attrs) {
-				if (attr.function != ToyDBMS::SelectionPart::AggregateFunction::NONE) {
-					throw std::runtime_error("Unsupported aggregation function");
-				}
-
 				attributesInProjection.insert(attr.attribute);
 			}
 
 			break;
 		}
 
+		case ToyDBMS::SelectionClause::Type::COUNT:
+			break;
+
 		default:
 			throw std::runtime_error("Unsupported selection clause");
 	}
@@ -404,6 +745,179 @@ std::vector<std::string> ConstructedQuery::getUniqueAttributes(const Query &quer
 	return std::move(uniqueAttributes);
 }
 
+std::vector<std::string> ConstructedQuery::getOrderedGroupByAttributes(const Query &query) {
+	std::vector<std::string> orderedAttributes;
+	for (const std::string &attribute : query.groupby) {
+		auto it = catalog.tables.find(table_name(attribute));
+		if (it == catalog.tables.end()) {
+			continue;
+		}
+
+		auto column = it->second.columns.find(attribute.substr(attribute.find('.') + 1));
+		if (column == it->second.columns.end()) {
+			continue;
+		}
+
+		if (column->second.order == Column::SortOrder::ASC || column->second.order == Column::SortOrder::DESC) {
+			orderedAttributes.push_back(attribute);
+		}
+	}
+
+	return orderedAttributes;
+}
+
+// The joins keep the order of the rows of the table that drives them. That
+// order is the ORDER BY one if all the attributes are columns of that table
+// and are ascending up to the first unique one: the rows with equal values of
+// a unique column come from the same row of the table.
+bool ConstructedQuery::isOrderGuaranteed(const std::vector<std::string> &orderBy, const std::string &orderedTable) {
+	auto it = catalog.tables.find(orderedTable);
+	if (it == catalog.tables.end()) {
+		return false;
+	}
+
+	bool afterUnique = false;
+	for (const std::string &attribute : orderBy) {
+		if (table_name(attribute) != orderedTable) {
+			return false;
+		}
+
+		if (afterUnique) {
+			continue;
+		}
+
+		auto column = it->second.columns.find(attribute.substr(attribute.find('.') + 1));
+		if (column == it->second.columns.end() || column->second.order != Column::SortOrder::ASC) {
+			return false;
+		}
+
+		afterUnique = column->second.unique;
+	}
+
+	return true;
+}
+
+static bool is_selected(const Query &query, const std::string &attribute) {
+	if (query.selection.type == ToyDBMS::SelectionClause::Type::ALL) {
+		return true;
+	}
+
+	for (const SelectionPart &attr : query.selection.attrs) {
+		if (attr.function == ToyDBMS::SelectionPart::AggregateFunction::NONE && attr.attribute == attribute) {
+			return true;
+		}
+	}
+
+	return false;
+}
+
+bool ConstructedQuery::answerCountFromCatalog(const Query &query) {
+	if (query.selection.type != ToyDBMS::SelectionClause::Type::COUNT
+			|| query.where != nullptr || !query.groupby.empty() || query.from.size() != 1
+			|| query.from[0]->type != FromPart::Type::TABLE) {
+		return false;
+	}
+
+	const std::string &tableName = dynamic_cast<const FromTable&>(*query.from[0]).table_name;
+	auto it = catalog.tables.find(tableName);
+	if (it == catalog.tables.end()) {
+		return false;
+	}
+
+	resultingOperator = std::make_unique<ConstantRow>(
+		Header {"COUNT(*)"}, std::vector<Value> {Value(static_cast<int>(it->second.rows))}
+	);
+	resultingOperator->setEstimatedRows(1);
+
+	return true;
+}
+
+// Sorts the rows by the ORDER BY attributes. If a LIMIT applies to the sorted
+// rows directly and its rows fit into the memory of a sort, only they are
+// kept, and `limited` is set.
+static std::unique_ptr<Operator> apply_sort(std::unique_ptr<Operator> op, const Query &query, bool &limited) {
+	size_t rowBytes = std::max<size_t>(op->header().size(), 1) * sizeof(Value);
+	if (query.limit < 0 || query.distinct || size_t(query.limit) > Sort::memory() / rowBytes) {
+		return std::make_unique<Sort>(std::move(op), query.orderby);
+	}
+
+	double rows = op->estimatedRows();
+	op = std::make_unique<TopN>(std::move(op), query.orderby, query.limit);
+	op->setEstimatedRows(rows >= 0 ? std::min<double>(rows, query.limit) : query.limit);
+	limited = true;
+	return op;
+}
+
+// Groups the joined tables by the GROUP BY attributes and projects the aggregates
+// in the order of the selection list. If the input is ordered on some of the
+// group-by attributes the groups are formed on the fly, otherwise they are hashed.
+static std::unique_ptr<Operator> apply_aggregation(
+	std::unique_ptr<Operator> op,
+	const Query &query,
+	const std::vector<std::string> &orderedAttributes,
+	bool &limited
+) {
+	std::vector<Aggregate> aggregates;
+	Header header;
+
+	switch (query.selection.type) {
+		case ToyDBMS::SelectionClause::Type::COUNT: {
+			aggregates.emplace_back(Aggregate::Function::COUNT);
+			header.push_back(aggregates.back().name());
+			break;
+		}
+
+		case ToyDBMS::SelectionClause::Type::LIST: {
+			std::unordered_set<std::string> groupBy(query.groupby.begin(), query.groupby.end());
+
+			for (const SelectionPart &attr : query.selection.attrs) {
+				switch (attr.function) {
+					case ToyDBMS::SelectionPart::AggregateFunction::NONE: {
+						if (groupBy.find(attr.attribute) == groupBy.end()) {
+							throw std::runtime_error("attribute " + attr.attribute + " must appear in GROUP BY");
+						}
+
+						header.push_back(attr.attribute);
+						break;
+					}
+
+					case ToyDBMS::SelectionPart::AggregateFunction::MINIMUM: {
+						aggregates.emplace_back(Aggregate::Function::MINIMUM, attr.attribute);
+						header.push_back(aggregates.back().name());
+						break;
+					}
+
+					default:
+						throw std::runtime_error("Unsupported aggregation function");
+				}
+			}
+
+			break;
+		}
+
+		default:
+			throw std::runtime_error("Unsupported selection clause with aggregation");
+	}
+
+	if (orderedAttributes.empty()) {
+		op = std::make_unique<HashAggregate>(std::move(op), query.groupby, aggregates);
+	} else {
+		op = std::make_unique<SortedAggregate>(std::move(op), query.groupby, aggregates, orderedAttributes);
+	}
+
+	// without GROUP BY there is exactly one group
+	if (query.groupby.empty()) {
+		op->setEstimatedRows(1);
+	}
+
+	// the groups are sorted before the projection, which may drop the attributes
+	if (!query.orderby.empty()) {
+		op = apply_sort(std::move(op), query, limited);
+	}
+
+	return std::make_unique<Projection>(std::move(op), std::move(header));
+}
+
 std::string chooseTableWithMaxNumOfAttributes(const std::vector<std::string> &attributes) {
 	std::unordered_map<std::string, int> attributesFromTable;
 	for (const std::string &attribute : attributes) {
@@ -424,20 +938,51 @@ std::string chooseTableWithMaxNumOfAttributes(const std::vector<std::string> &at
 }
 
 ConstructedQuery::ConstructedQuery(const Query &query) {
+	construct(query);
+	if (query.limit < 0 || limited) {
+		return;
+	}
+
+	// the rows after the limit are not produced, with several threads at most
+	// the morsels in flight when the limit is reached are
+	double rows = resultingOperator->estimatedRows();
+	if (ThreadPool::threads() > 1) {
+		resultingOperator = std::make_unique<Gather>(std::move(resultingOperator), true);
+	}
+	resultingOperator = std::make_unique<Limit>(std::move(resultingOperator), query.limit);
+	resultingOperator->setEstimatedRows(rows >= 0 ? std::min<double>(rows, query.limit) : query.limit);
+}
+
+void ConstructedQuery::construct(const Query &query) {
 	std::vector<std::string> tablesNames = getTablesNames(query);
 	createCatalog(tablesNames);
 
-	std::vector<std::string> orderedAttributes = getOrderedAttributes(query);
+	bool isAggregated = is_aggregated(query);
+	if (isAggregated && answerCountFromCatalog(query)) {
+		return;
+	}
+
+	std::vector<std::string> orderedAttributes =
+		isAggregated ? getOrderedGroupByAttributes(query) : getOrderedAttributes(query);
 	std::vector<std::string> uniqueAttributes = getUniqueAttributes(query);
 
 	std::unordered_map<std::string, std::unique_ptr<Operator>> tables = processQueryOperators(query);
 	PredicatesLists predicatesLists = createPredicatesLists(query);
 
-	apply_const_filters(tables, predicatesLists.constFilterPredicates);
+	apply_const_filters(tables, predicatesLists.constFilterPredicates, predicatesLists.joinPredicates);
 	apply_attribute_inequality_filters(tables, predicatesLists.attributesInequalityFilterPredicates);
+	apply_subquery_filters(tables, predicatesLists.subqueryPredicates);
+	load_tables_in_parallel(tables);
 
 	bool isOrdered = false;
 	std::string orderedTable = chooseTableWithMaxNumOfAttributes(orderedAttributes);
+
+	// a table ordered on the first ORDER BY attribute drives the joins, so that
+	// its order may make the sort unnecessary
+	if (!isAggregated && !query.orderby.empty()
+			&& std::find(orderedAttributes.begin(), orderedAttributes.end(), query.orderby[0]) != orderedAttributes.end()) {
+		orderedTable = table_name(query.orderby[0]);
+	}
 	std::vector<JoinApplicationResult> isolatedTables;
 
 	if (orderedAttributes.size() == 0) {
@@ -454,9 +999,46 @@ ConstructedQuery::ConstructedQuery(const Query &query) {
 			rightOperator = std::make_unique<Cache>(std::move(rightOperator));
 		}
 
+		double leftRows = resultingOperator->estimatedRows();
+		double rightRows = rightOperator->estimatedRows();
 		resultingOperator = std::make_unique<CrossJoin>(
 			std::move(resultingOperator), std::move(rightOperator)
 		);
+
+		if (leftRows >= 0 && rightRows >= 0) {
+			resultingOperator->setEstimatedRows(leftRows * rightRows);
+		}
+	}
+
+	if (isAggregated) {
+		std::vector<std::string> attributes;
+		for (const std::string &attribute : orderedAttributes) {
+			if (table_name(attribute) == orderedTable) {
+				attributes.push_back(attribute);
+			}
+		}
+
+		resultingOperator = apply_aggregation(std::move(resultingOperator), query, attributes, limited);
+
+		if (query.distinct) {
+			resultingOperator = std::make_unique<Unique>(std::move(resultingOperator));
+		}
+
+		return;
+	}
+
+	// The rows are sorted after the projection if it keeps the ORDER BY
+	// attributes, they are narrower there.
+	bool sorted = false;
+	bool sortedAfterProjection = false;
+	if (!query.orderby.empty() && !(isOrdered && isOrderGuaranteed(query.orderby, orderedTable))) {
+		sorted = true;
+		sortedAfterProjection = std::all_of(query.orderby.begin(), query.orderby.end(),
+			[&query](const std::string &attribute) { return is_selected(query, attribute); });
+
+		if (!sortedAfterProjection) {
+			resultingOperator = apply_sort(std::move(resultingOperator), query, limited);
+		}
 	}
 
 	switch (query.selection.type) {
@@ -485,6 +1067,10 @@ ConstructedQuery::ConstructedQuery(const Query &query) {
 			throw std::runtime_error("Unsupported selection clause");
 	}
 
+	if (sortedAfterProjection) {
+		resultingOperator = apply_sort(std::move(resultingOperator), query, limited);
+	}
+
 	/*
 	if (getAttributesInResult(query).size() < 15) {
 		failingTest = false;
@@ -499,7 +1085,11 @@ ConstructedQuery::ConstructedQuery(const Query &query) {
 			return;
 		}
 
-		if (isOrdered) {
+		// the sorted rows with equal ORDER BY attributes are adjacent, so only
+		// those have to be compared with each other
+		if (sortedAfterProjection) {
+			resultingOperator = std::make_unique<OptimizedUnique>(std::move(resultingOperator), query.orderby);
+		} else if (isOrdered && !sorted) {
 			std::vector<std::string> attributes;
 
 			if (tablesNames.size() == 1) {
@@ -10,6 +10,7 @@ namespace ToyDBMS {
 		private:
 			std::unique_ptr<Operator> resultingOperator;
 			Catalog catalog;
+			bool limited = false; // the plan returns no more rows than the LIMIT
 
 		public:
 			ConstructedQuery(const Query &query);
@@ -19,6 +20,7 @@ namespace ToyDBMS {
 			const Catalog& getCatalog();
 
 		private:
+			void construct(const Query &query);
 			void createCatalog(const std::vector<std::string> &tablesNames);
 			std::unordered_map<std::string, std::unique_ptr<Operator>> processQueryOperators(
 				const Query &query
@@ -26,7 +28,8 @@ namespace ToyDBMS {
 
 			void apply_const_filters(
 				std::unordered_map<std::string, std::unique_ptr<Operator>> &tables,
-				const std::vector<ConstPredicate*> &constFilterPredicates
+				const std::vector<ConstPredicate*> &constFilterPredicates,
+				const std::vector<AttributePredicate*> &joinPredicates
 			);
 
 			void apply_attribute_inequality_filters(
@@ -34,8 +37,19 @@ namespace ToyDBMS {
 				const std::vector<AttributePredicate*> &inequalityPredicates
 			);
 
+			void apply_subquery_filters(
+				std::unordered_map<std::string, std::unique_ptr<Operator>> &tables,
+				const std::vector<QueryPredicate*> &subqueryPredicates
+			);
+
 			std::vector<std::string> getOrderedAttributes(const Query &query);
 
+			std::vector<std::string> getOrderedGroupByAttributes(const Query &query);
+
+			bool isOrderGuaranteed(const std::vector<std::string> &orderBy, const std::string &orderedTable);
+
+			bool answerCountFromCatalog(const Query &query);
+
 			std::vector<std::string> getUniqueAttributes(const Query &query);
 
 			std::unordered_set<std::string> getAttributesInResult(const Query &query);
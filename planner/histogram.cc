@@ -1,29 +1,105 @@
 #include "histogram.h"
+#include <algorithm>
+#include <cmath>
 #include <fstream>
+#include <sstream>
 
 namespace ToyDBMS {
 
 Histogram Histogram::load(std::string filename, Value::Type type){
     std::ifstream file(filename);
     Histogram result;
-    std::string min, max;
-    size_t count;
-    while(file >> min >> max >> count){
-        Bucket bucket;
-        bucket.min = Value{type, min};
-        bucket.max = Value{type, max};
-        bucket.count = count;
-        result.buckets.push_back(std::move(bucket));
+    std::string line;
+    while(getline(file, line)){
+        std::istringstream parts(line);
+        std::string min, max;
+        size_t count, distinct = 0;
+        if(!(parts >> min >> max >> count)) continue;
+        parts >> distinct;
+        result.buckets.push_back(Bucket {Value(min, type), Value(max, type), count, distinct});
     }
     return result;
 }
 
-Histogram Histogram::intersect(const Histogram &other){
-    return {};
+// Number of distinct values in the bucket: recorded by the generator,
+// otherwise bounded by the width of an integer bucket.
+static double distinct_values(const Bucket &bucket){
+    if(bucket.distinct != 0) return bucket.distinct;
+    if(bucket.min.type != Value::Type::INT) return std::max<size_t>(1, bucket.count);
+    return std::max(1.0, std::min<double>(bucket.count, double(bucket.max.intval()) - bucket.min.intval() + 1));
 }
 
-size_t Histogram::num_elements(const Histogram &other){
+// Fraction of the bucket strictly below the value, assuming the values are
+// spread uniformly; string buckets are split in half.
+static double fraction_below(const Bucket &bucket, const Value &value){
+    if(value <= bucket.min) return 0;
+    if(bucket.max < value) return 1;
+    if(bucket.min.type != Value::Type::INT) return 0.5;
+    return (double(value.intval()) - bucket.min.intval()) / (double(bucket.max.intval()) - bucket.min.intval() + 1);
+}
+
+double Histogram::estimate_less(const Value &value) const {
+    double result = 0;
+    for(const Bucket &bucket : buckets)
+        result += bucket.count * fraction_below(bucket, value);
+    return result;
+}
+
+double Histogram::estimate_equal(const Value &value) const {
+    for(const Bucket &bucket : buckets){
+        if(bucket.min <= value && value <= bucket.max)
+            return bucket.count / distinct_values(bucket);
+    }
     return 0;
 }
 
+double Histogram::estimate_greater(const Value &value) const {
+    return std::max(0.0, num_elements() - estimate_less(value) - estimate_equal(value));
+}
+
+// Part of the bucket that falls into [lo, hi] and the number of distinct values
+// expected there. String buckets have no width, so they are taken as a whole.
+static void overlap(const Bucket &bucket, const Value &lo, const Value &hi, double &rows, double &distinct){
+    if(bucket.min.type != Value::Type::INT){
+        rows = bucket.count;
+        distinct = distinct_values(bucket);
+        return;
+    }
+
+    double width = double(bucket.max.intval()) - bucket.min.intval() + 1;
+    double fraction = (double(hi.intval()) - lo.intval() + 1) / width;
+    rows = bucket.count * fraction;
+    distinct = distinct_values(bucket) * fraction;
+}
+
+Histogram Histogram::intersect(const Histogram &other) const {
+    Histogram result;
+    for(const Bucket &a : buckets){
+        for(const Bucket &b : other.buckets){
+            if(a.min.type != b.min.type || a.max < b.min || b.max < a.min) continue;
+
+            const Value &lo = std::max(a.min, b.min);
+            const Value &hi = std::min(a.max, b.max);
+
+            double aRows, aDistinct, bRows, bDistinct;
+            overlap(a, lo, hi, aRows, aDistinct);
+            overlap(b, lo, hi, bRows, bDistinct);
+
+            double rows = aRows * bRows / std::max(1.0, std::max(aDistinct, bDistinct));
+            double joinedDistinct = std::min(aDistinct, bDistinct);
+            result.buckets.push_back(Bucket {
+                lo, hi, static_cast<size_t>(std::llround(rows)), static_cast<size_t>(std::llround(joinedDistinct))
+            });
+        }
+    }
+    return result;
+}
+
+size_t Histogram::num_elements() const {
+    size_t result = 0;
+    for(const Bucket &bucket : buckets)
+        result += bucket.count;
+    return result;
+}
+
 }
@@ -4,9 +4,12 @@
 
 namespace ToyDBMS {
 
+// Bucket covers the values in [min, max], both bounds included.
+// distinct is 0 if the histogram file does not record it.
 struct Bucket {
     Value min, max;
     size_t count;
+    size_t distinct;
 };
 
 struct Histogram {
@@ -14,8 +17,17 @@ struct Histogram {
 
     static Histogram load(std::string filename, Value::Type type);
 
+    // Estimated histogram of the equi-join of two columns: for every pair of
+    // overlapping buckets the overlapping part is assumed to be uniform.
     Histogram intersect(const Histogram &other) const;
     size_t num_elements() const;
+
+    // Estimated number of values less than, equal to and greater than the given one.
+    double estimate_less(const Value &value) const;
+    double estimate_equal(const Value &value) const;
+    double estimate_greater(const Value &value) const;
+
+    bool empty() const { return buckets.empty(); }
 };
 
 }
@@ -0,0 +1,250 @@
+#include "join_order_optimizer.h"
+
+#include "utils.h"
+
+#include <algorithm>
+#include <limits>
+#include <stdexcept>
+
+namespace ToyDBMS {
+
+JoinOrderOptimizer::JoinOrderOptimizer(
+	const std::vector<std::string> &tables,
+	const std::vector<AttributePredicate*> &joinPredicates,
+	const Catalog &catalog
+) : catalog(catalog),
+	tables(tables),
+	selectivity(tables.size(), std::vector<double>(tables.size(), 1.0)),
+	connected(tables.size(), std::vector<bool>(tables.size(), false)) {
+	for (const std::string &table : this->tables) {
+		auto it = catalog.tables.find(table);
+		tableRows.push_back(it == catalog.tables.end() ? 1.0 : std::max<double>(1.0, it->second.rows));
+	}
+
+	auto indexOf = [this](const std::string &table) -> size_t {
+		auto it = std::find(this->tables.begin(), this->tables.end(), table);
+		if (it == this->tables.end()) {
+			throw std::runtime_error("Unknown table: " + table);
+		}
+
+		return it - this->tables.begin();
+	};
+
+	for (AttributePredicate *predicate : joinPredicates) {
+		size_t left = indexOf(table_name(predicate->left));
+		size_t right = indexOf(table_name(predicate->right));
+
+		double predicateSelectivity = this->predicateSelectivity(*predicate);
+		selectivity[left][right] *= predicateSelectivity;
+		selectivity[right][left] *= predicateSelectivity;
+		connected[left][right] = connected[right][left] = true;
+	}
+}
+
+const Column *JoinOrderOptimizer::findColumn(const std::string &attribute) const {
+	auto table = catalog.tables.find(table_name(attribute));
+	if (table == catalog.tables.end()) {
+		return nullptr;
+	}
+
+	auto column = table->second.columns.find(attribute.substr(attribute.find('.') + 1));
+	return column == table->second.columns.end() ? nullptr : &column->second;
+}
+
+double JoinOrderOptimizer::predicateSelectivity(const AttributePredicate &predicate) const {
+	auto rowsOf = [this](const std::string &attribute) {
+		auto it = std::find(tables.begin(), tables.end(), table_name(attribute));
+		return tableRows[it - tables.begin()];
+	};
+
+	double leftRows = rowsOf(predicate.left);
+	double rightRows = rowsOf(predicate.right);
+
+	if (predicate.relation != Predicate::Relation::EQUAL) {
+		return 1.0 / 3;
+	}
+
+	const Column *left = findColumn(predicate.left);
+	const Column *right = findColumn(predicate.right);
+
+	if (left != nullptr && right != nullptr && !left->histogram.empty() && !right->histogram.empty()) {
+		double leftElements = left->histogram.num_elements();
+		double rightElements = right->histogram.num_elements();
+
+		if (leftElements > 0 && rightElements > 0) {
+			double joined = left->histogram.intersect(right->histogram).num_elements();
+			return joined / (leftElements * rightElements);
+		}
+	}
+
+	// every row matches at most one row of the table with a unique column
+	bool leftUnique = left != nullptr && left->unique;
+	bool rightUnique = right != nullptr && right->unique;
+	if (leftUnique && !rightUnique) {
+		return 1.0 / leftRows;
+	}
+
+	if (rightUnique && !leftUnique) {
+		return 1.0 / rightRows;
+	}
+
+	return 1.0 / std::max(leftRows, rightRows);
+}
+
+std::vector<JoinOrder> JoinOrderOptimizer::optimize(const std::string &firstTable) {
+	std::vector<size_t> starts;
+	if (!firstTable.empty()) {
+		auto it = std::find(tables.begin(), tables.end(), firstTable);
+		if (it == tables.end()) {
+			throw std::runtime_error("Unknown table: " + firstTable);
+		}
+
+		starts.push_back(it - tables.begin());
+	}
+
+	for (size_t i = 0; i < tables.size(); i++) {
+		starts.push_back(i);
+	}
+
+	std::vector<JoinOrder> orders;
+	std::vector<bool> visited(tables.size(), false);
+
+	for (size_t start : starts) {
+		if (visited[start]) {
+			continue;
+		}
+
+		// the start table goes first so that a fixed first table stays in front
+		std::vector<size_t> component {start};
+		visited[start] = true;
+
+		for (size_t i = 0; i < component.size(); i++) {
+			for (size_t j = 0; j < tables.size(); j++) {
+				if (connected[component[i]][j] && !visited[j]) {
+					visited[j] = true;
+					component.push_back(j);
+				}
+			}
+		}
+
+		bool fixFirst = !firstTable.empty() && orders.empty();
+		if (component.size() <= MAX_DP_TABLES) {
+			orders.push_back(orderByDP(component, fixFirst));
+		} else {
+			orders.push_back(orderGreedily(component, fixFirst));
+		}
+	}
+
+	return orders;
+}
+
+JoinOrder JoinOrderOptimizer::orderByDP(const std::vector<size_t> &component, bool fixFirst) {
+	size_t n = component.size();
+	size_t subsets = size_t(1) << n;
+	double infinity = std::numeric_limits<double>::infinity();
+
+	std::vector<double> rows(subsets, 0), cost(subsets, infinity);
+	std::vector<size_t> last(subsets, 0);
+
+	for (size_t i = 0; i < (fixFirst ? 1 : n); i++) {
+		rows[size_t(1) << i] = tableRows[component[i]];
+		cost[size_t(1) << i] = 0;
+		last[size_t(1) << i] = i;
+	}
+
+	// a subset is always larger than the subsets it is built from,
+	// so increasing order visits every subset after its best plan is known
+	for (size_t mask = 1; mask < subsets; mask++) {
+		if (cost[mask] == infinity) {
+			continue;
+		}
+
+		for (size_t j = 0; j < n; j++) {
+			if (mask & (size_t(1) << j)) {
+				continue;
+			}
+
+			bool isConnected = false;
+			double joined = rows[mask] * tableRows[component[j]];
+			for (size_t k = 0; k < n; k++) {
+				if (mask & (size_t(1) << k)) {
+					isConnected = isConnected || connected[component[j]][component[k]];
+					joined *= selectivity[component[j]][component[k]];
+				}
+			}
+
+			if (!isConnected) {
+				continue;
+			}
+
+			joined = std::max(1.0, joined);
+			size_t extended = mask | (size_t(1) << j);
+			if (cost[mask] + joined < cost[extended]) {
+				cost[extended] = cost[mask] + joined;
+				rows[extended] = joined;
+				last[extended] = j;
+			}
+		}
+	}
+
+	JoinOrder order;
+	for (size_t mask = subsets - 1; mask != 0; mask ^= size_t(1) << last[mask]) {
+		order.tables.push_back(tables[component[last[mask]]]);
+		order.rows.push_back(rows[mask]);
+	}
+
+	std::reverse(order.tables.begin(), order.tables.end());
+	std::reverse(order.rows.begin(), order.rows.end());
+	return order;
+}
+
+JoinOrder JoinOrderOptimizer::orderGreedily(const std::vector<size_t> &component, bool fixFirst) {
+	size_t first = 0;
+	if (!fixFirst) {
+		for (size_t i = 1; i < component.size(); i++) {
+			if (tableRows[component[i]] < tableRows[component[first]]) {
+				first = i;
+			}
+		}
+	}
+
+	std::vector<bool> used(component.size(), false);
+	used[first] = true;
+
+	JoinOrder order;
+	order.tables.push_back(tables[component[first]]);
+	order.rows.push_back(tableRows[component[first]]);
+
+	for (size_t step = 1; step < component.size(); step++) {
+		size_t best = component.size();
+		double bestRows = 0;
+
+		for (size_t j = 0; j < component.size(); j++) {
+			if (used[j]) {
+				continue;
+			}
+
+			bool isConnected = false;
+			double joined = order.rows.back() * tableRows[component[j]];
+			for (size_t k = 0; k < component.size(); k++) {
+				if (used[k]) {
+					isConnected = isConnected || connected[component[j]][component[k]];
+					joined *= selectivity[component[j]][component[k]];
+				}
+			}
+
+			if (isConnected && (best == component.size() || joined < bestRows)) {
+				best = j;
+				bestRows = joined;
+			}
+		}
+
+		used[best] = true;
+		order.tables.push_back(tables[component[best]]);
+		order.rows.push_back(std::max(1.0, bestRows));
+	}
+
+	return order;
+}
+
+}
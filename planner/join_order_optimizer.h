@@ -0,0 +1,52 @@
+#pragma once
+#include <string>
+#include <vector>
+#include "../parser/query.h"
+#include "catalog.h"
+
+namespace ToyDBMS {
+	// Tables of one connected component of the join graph in the order they should
+	// be joined, with the estimated number of rows after each of the joins
+	// (rows[0] is the size of the first table).
+	struct JoinOrder {
+		std::vector<std::string> tables;
+		std::vector<double> rows;
+	};
+
+	// Chooses a left-deep join order without cross products for every connected
+	// component of the join graph, minimizing the sum of the estimated sizes of
+	// intermediate results. Components of up to MAX_DP_TABLES tables are enumerated
+	// exhaustively by dynamic programming over subsets, larger ones are ordered greedily.
+	// Join selectivities are estimated from column histograms when both columns
+	// have them, from UNIQUE flags and row counts otherwise.
+	class JoinOrderOptimizer {
+		public:
+			static constexpr size_t MAX_DP_TABLES = 12;
+
+		private:
+			const Catalog &catalog;
+			std::vector<std::string> tables;
+			std::vector<double> tableRows;
+
+			// product of selectivities of the predicates between two tables, 1 if there are none
+			std::vector<std::vector<double>> selectivity;
+			std::vector<std::vector<bool>> connected;
+
+		public:
+			JoinOrderOptimizer(
+				const std::vector<std::string> &tables,
+				const std::vector<AttributePredicate*> &joinPredicates,
+				const Catalog &catalog
+			);
+
+			// If firstTable is not empty its component is returned first and starts with it.
+			std::vector<JoinOrder> optimize(const std::string &firstTable);
+
+		private:
+			const Column *findColumn(const std::string &attribute) const;
+			double predicateSelectivity(const AttributePredicate &predicate) const;
+
+			JoinOrder orderByDP(const std::vector<size_t> &component, bool fixFirst);
+			JoinOrder orderGreedily(const std::vector<size_t> &component, bool fixFirst);
+	};
+}
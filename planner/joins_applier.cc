@@ -12,43 +12,72 @@
 namespace ToyDBMS {
 
 std::vector<JoinApplicationResult> JoinsApplier::applyJoins() {
-	return applyJoins(tables.begin()->first);
+	return applyJoins("", false);
 }
 
 std::vector<JoinApplicationResult> JoinsApplier::applyJoins(const std::string &firstTable) {
+	return applyJoins(firstTable, true);
+}
+
+std::vector<JoinApplicationResult> JoinsApplier::applyJoins(
+	const std::string &firstTable,
+	bool preserveFirstTableOrder
+) {
+	std::vector<std::string> tablesNames;
+	for (const auto &kv : tables) {
+		tablesNames.push_back(kv.first);
+	}
+
+	std::vector<JoinOrder> orders =
+		JoinOrderOptimizer(tablesNames, joinPredicates, catalog).optimize(firstTable);
+
 	std::vector<JoinApplicationResult> isolatedTables;
+	for (size_t i = 0; i < orders.size(); i++) {
+		isolatedTables.push_back(processTables(orders[i], preserveFirstTableOrder && i == 0));
+	}
 
-	auto it = tables.find(firstTable);
-	if (it == tables.end()) {
-		throw std::runtime_error("Unknown table!");
+	return isolatedTables;
+}
+
+size_t JoinsApplier::tableRows(const std::string &table) {
+	auto it = catalog.tables.find(table);
+	if (it == catalog.tables.end()) {
+		return 0;
 	}
 
-	isolatedTables.push_back(processTable(*it));
+	return it->second.rows;
+}
 
-	for (std::pair<const std::string, std::unique_ptr<Operator>> &table : tables) {
-		if (usedTables.find(table.first) != usedTables.end()) {
-			continue;
-		}
+std::unordered_map<std::string, Column::SortOrder> JoinsApplier::sortedColumns(const std::string &table) {
+	std::unordered_map<std::string, Column::SortOrder> result;
 
-		isolatedTables.push_back(processTable(table));
+	auto it = catalog.tables.find(table);
+	if (it == catalog.tables.end()) {
+		return result;
 	}
 
-	return isolatedTables;
+	for (const auto &kv : it->second.columns) {
+		if (kv.second.order == Column::SortOrder::ASC || kv.second.order == Column::SortOrder::DESC) {
+			result.insert(std::make_pair(table + "." + kv.first, kv.second.order));
+		}
+	}
+
+	return result;
 }
 
-JoinApplicationResult JoinsApplier::processTable(std::pair<const std::string, std::unique_ptr<Operator>> &table) {
-	usedTables.insert(table.first);
-	std::unique_ptr<Operator> currentRelation = std::move(table.second);
+JoinApplicationResult JoinsApplier::processTables(const JoinOrder &order, bool preserveOrder) {
+	const std::string &firstTable = order.tables[0];
+	usedTables.insert(firstTable);
+	std::unique_ptr<Operator> currentRelation = std::move(tables[firstTable]);
+	double currentRows = order.rows[0];
+	std::unordered_map<std::string, Column::SortOrder> currentOrder = sortedColumns(firstTable);
 
-	bool wasJoin = false;
-	while (true) {
-		int i = findNextJoinPredicate();
+	for (size_t step = 1; step < order.tables.size(); step++) {
+		int i = findJoinPredicate(order.tables[step]);
 		if (i == -1) {
-			break;
+			throw std::runtime_error("No join predicate for table " + order.tables[step]);
 		}
 
-		wasJoin = true;
-
 		std::string leftAttribute = joinPredicates[i]->left;
 		std::string rightAttribute = joinPredicates[i]->right;
 		std::string leftTable = table_name(leftAttribute);
@@ -59,10 +88,46 @@ JoinApplicationResult JoinsApplier::processTable(std::pair<const std::string, st
 			std::swap(leftAttribute, rightAttribute);
 		}
 
-		currentRelation = std::make_unique<NLJoin>(
-			std::move(currentRelation), std::move(tables[rightTable]),
-			leftAttribute, rightAttribute
-		);
+		size_t rightRows = tableRows(rightTable);
+		auto leftOrder = currentOrder.find(leftAttribute);
+		const Column &rightColumn = catalog.getColumn(rightAttribute);
+
+		if (
+			joinPredicates[i]->relation == Predicate::Relation::EQUAL &&
+			leftOrder != currentOrder.end() &&
+			leftOrder->second == rightColumn.order &&
+			catalog.getColumn(leftAttribute).type == rightColumn.type
+		) {
+			Column::SortOrder sortOrder = leftOrder->second;
+			currentRelation = std::make_unique<MergeJoin>(
+				std::move(currentRelation), std::move(tables[rightTable]),
+				leftAttribute, rightAttribute, sortOrder == Column::SortOrder::DESC
+			);
+
+			currentOrder[rightAttribute] = sortOrder;
+		} else if (joinPredicates[i]->relation == Predicate::Relation::EQUAL) {
+			// The probe side streams, so probing with the current relation keeps its order.
+			HashJoin::BuildSide buildSide = preserveOrder || rightRows <= currentRows
+				? HashJoin::BuildSide::RIGHT
+				: HashJoin::BuildSide::LEFT;
+
+			currentRelation = std::make_unique<HashJoin>(
+				std::move(currentRelation), std::move(tables[rightTable]),
+				leftAttribute, rightAttribute, buildSide
+			);
+
+			if (buildSide == HashJoin::BuildSide::LEFT) {
+				currentOrder = sortedColumns(rightTable);
+			}
+		} else {
+			currentRelation = std::make_unique<NLJoin>(
+				std::move(currentRelation), std::move(tables[rightTable]),
+				leftAttribute, rightAttribute
+			);
+		}
+
+		currentRows = order.rows[step];
+		currentRelation->setEstimatedRows(currentRows);
 		usedTables.insert(rightTable);
 		usedPredicates[i] = true;
 
@@ -90,56 +155,27 @@ JoinApplicationResult JoinsApplier::processTable(std::pair<const std::string, st
 		}
 	}
 
-	return JoinApplicationResult(wasJoin, std::move(currentRelation));
+	return JoinApplicationResult(order.tables.size() > 1, std::move(currentRelation));
 }
 
-int JoinsApplier::findNextJoinPredicate() {
-	for (size_t i = 0; i < joinPredicates.size(); i++) {
-		if (usedPredicates[i]) {
-			continue;
-		}
-
-		std::string leftAttribute = joinPredicates[i]->left;
-		std::string rightAttribute = joinPredicates[i]->right;
-		std::string leftTable = table_name(leftAttribute);
-		std::string rightTable = table_name(rightAttribute);
-
-		if (!catalog.getColumn(leftAttribute).unique && !catalog.getColumn(rightAttribute).unique) {
-			continue;
-		}
-
-		if (
-			usedTables.find(leftTable) == usedTables.end() &&
-			usedTables.find(rightTable) == usedTables.end()
-		) {
-			continue;
-		}
-
-		return i;
-	}
-
+int JoinsApplier::findJoinPredicate(const std::string &table) {
 	for (size_t i = 0; i < joinPredicates.size(); i++) {
 		if (usedPredicates[i]) {
 			continue;
 		}
 
-		std::string leftAttribute = joinPredicates[i]->left;
-		std::string rightAttribute = joinPredicates[i]->right;
-		std::string leftTable = table_name(leftAttribute);
-		std::string rightTable = table_name(rightAttribute);
+		std::string leftTable = table_name(joinPredicates[i]->left);
+		std::string rightTable = table_name(joinPredicates[i]->right);
 
 		if (
-			usedTables.find(leftTable) == usedTables.end() &&
-			usedTables.find(rightTable) == usedTables.end()
+			(leftTable == table && usedTables.find(rightTable) != usedTables.end()) ||
+			(rightTable == table && usedTables.find(leftTable) != usedTables.end())
 		) {
-			continue;
+			return i;
 		}
-
-		return i;
 	}
 
 	return -1;
 }
 
 }
-
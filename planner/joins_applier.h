@@ -4,8 +4,11 @@
 #include "../operators/operator.h"
 #include "../operators/filter.h"
 #include "../operators/join.h"
+#include "../operators/hashjoin.h"
+#include "../operators/mergejoin.h"
 
 #include "catalog.h"
+#include "join_order_optimizer.h"
 
 #include <unordered_set>
 #include <unordered_map>
@@ -47,8 +50,17 @@ namespace ToyDBMS {
 			std::vector<JoinApplicationResult> applyJoins(const std::string &firstTable);
 
 		private:
-			JoinApplicationResult processTable(std::pair<const std::string, std::unique_ptr<Operator>> &table);
+			std::vector<JoinApplicationResult> applyJoins(const std::string &firstTable, bool preserveFirstTableOrder);
 
-			int findNextJoinPredicate();
+			// Joins the tables of one component in the given order.
+			JoinApplicationResult processTables(const JoinOrder &order, bool preserveOrder);
+
+			size_t tableRows(const std::string &table);
+
+			// Columns of the table that are sorted according to the catalog, by full attribute name.
+			std::unordered_map<std::string, Column::SortOrder> sortedColumns(const std::string &table);
+
+			// An unused predicate between the table and the tables joined so far, -1 if none.
+			int findJoinPredicate(const std::string &table);
 	};
 }
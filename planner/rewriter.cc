@@ -1,106 +1,186 @@
 #include "rewriter.h"
 
 namespace ToyDBMS {
-	ColumnsBounds rewrite_const_filters(const std::vector<ConstPredicate*> &constFilterPredicates) {
-		ColumnsBounds result;
-
-		for (ConstPredicate *predicate : constFilterPredicates) {
-			const std::string &attribute = predicate->attribute;
-			const Value &value = predicate->value;
-
-			switch (predicate->relation) {
-				case Predicate::Relation::EQUAL: {
-					auto it1 = result.columnUpperBound.find(attribute);
-					if (it1 != result.columnUpperBound.end()) {
-						if (it1->second <= value) {
-							result.isValid = false;
-							return result;
-						} else {
-							result.columnUpperBound.erase(it1);
-						}
+	// Narrows the bounds of the attribute by one more condition.
+	// Returns false if the condition contradicts the bounds.
+	static bool add_bound(
+		ColumnsBounds &bounds,
+		const std::string &attribute,
+		Predicate::Relation relation,
+		const Value &value
+	) {
+		switch (relation) {
+			case Predicate::Relation::EQUAL: {
+				auto it1 = bounds.columnUpperBound.find(attribute);
+				if (it1 != bounds.columnUpperBound.end()) {
+					if (it1->second <= value) {
+						return false;
+					} else {
+						bounds.columnUpperBound.erase(it1);
 					}
+				}
 
-					auto it2 = result.columnLowerBound.find(attribute);
-					if (it2 != result.columnLowerBound.end()) {
-						if (it2->second >= value) {
-							result.isValid = false;
-							return result;
-						} else {
-							result.columnLowerBound.erase(it2);
-						}
+				auto it2 = bounds.columnLowerBound.find(attribute);
+				if (it2 != bounds.columnLowerBound.end()) {
+					if (it2->second >= value) {
+						return false;
+					} else {
+						bounds.columnLowerBound.erase(it2);
 					}
+				}
 
-					auto it3 = result.columnExactValue.find(attribute);
-					if (it3 != result.columnExactValue.end()) {
-						if (it3->second != value) {
-							result.isValid = false;
-							return result;
-						}
-					} else {
-						result.columnExactValue.insert(std::make_pair(attribute, value));
+				auto it3 = bounds.columnExactValue.find(attribute);
+				if (it3 != bounds.columnExactValue.end()) {
+					if (it3->second != value) {
+						return false;
 					}
+				} else {
+					bounds.columnExactValue.insert(std::make_pair(attribute, value));
+				}
+
+				return true;
+			}
 
-					break;
+			case Predicate::Relation::LESS: {
+				auto it1 = bounds.columnExactValue.find(attribute);
+				if (it1 != bounds.columnExactValue.end()) {
+					return it1->second < value;
 				}
 
-				case Predicate::Relation::LESS: {
-					auto it1 = result.columnExactValue.find(attribute);
-					if (it1 != result.columnExactValue.end()) {
-						if (it1->second >= value) {
-							result.isValid = false;
-							return result;
-						} else {
-							break;
-						}
+				auto it2 = bounds.columnLowerBound.find(attribute);
+				if (it2 != bounds.columnLowerBound.end()) {
+					if (it2->second >= value) {
+						return false;
 					}
+				}
 
-					auto it2 = result.columnLowerBound.find(attribute);
-					if (it2 != result.columnLowerBound.end()) {
-						if (it2->second >= value) {
-							result.isValid = false;
-							return result;
-						}
-					}
+				auto it3 = bounds.columnUpperBound.find(attribute);
+				if (it3 == bounds.columnUpperBound.end() || it3->second > value) {
+					bounds.columnUpperBound.erase(attribute);
+					bounds.columnUpperBound.insert(std::make_pair(attribute, value));
+				}
 
-					auto it3 = result.columnUpperBound.find(attribute);
-					if (it3 == result.columnUpperBound.end() || it3->second > value) {
-						result.columnUpperBound.erase(attribute);
-						result.columnUpperBound.insert(std::make_pair(attribute, value));
-					}
+				return true;
+			}
 
-					break;
+			case Predicate::Relation::GREATER: {
+				auto it1 = bounds.columnExactValue.find(attribute);
+				if (it1 != bounds.columnExactValue.end()) {
+					return it1->second > value;
 				}
 
-				case Predicate::Relation::GREATER: {
-					auto it1 = result.columnExactValue.find(attribute);
-					if (it1 != result.columnExactValue.end()) {
-						if (it1->second <= value) {
-							result.isValid = false;
-							return result;
-						} else {
-							break;
-						}
+				auto it2 = bounds.columnUpperBound.find(attribute);
+				if (it2 != bounds.columnUpperBound.end()) {
+					if (it2->second <= value) {
+						return false;
 					}
+				}
 
-					auto it2 = result.columnUpperBound.find(attribute);
-					if (it2 != result.columnUpperBound.end()) {
-						if (it2->second <= value) {
-							result.isValid = false;
-							return result;
-						}
-					}
+				auto it3 = bounds.columnLowerBound.find(attribute);
+				if (it3 == bounds.columnLowerBound.end() || it3->second < value) {
+					bounds.columnLowerBound.erase(attribute);
+					bounds.columnLowerBound.insert(std::make_pair(attribute, value));
+				}
 
-					auto it3 = result.columnLowerBound.find(attribute);
-					if (it3 == result.columnLowerBound.end() || it3->second < value) {
-						result.columnLowerBound.erase(attribute);
-						result.columnLowerBound.insert(std::make_pair(attribute, value));
-					}
+				return true;
+			}
+
+			default:
+				throw std::runtime_error("Unsupported predicate relation");
+		}
+	}
 
-					break;
+	EquivalenceClasses::EquivalenceClasses(const std::vector<AttributePredicate*> &equalityPredicates) {
+		for (AttributePredicate *predicate : equalityPredicates) {
+			if (predicate->relation == Predicate::Relation::EQUAL) {
+				unite(predicate->left, predicate->right);
+			}
+		}
+	}
+
+	std::string EquivalenceClasses::find(const std::string &attribute) {
+		auto it = parent.find(attribute);
+		if (it == parent.end()) {
+			return attribute;
+		}
+
+		if (it->second == attribute) {
+			return attribute;
+		}
+
+		std::string root = find(it->second);
+		parent[attribute] = root;
+		return root;
+	}
+
+	void EquivalenceClasses::unite(const std::string &first, const std::string &second) {
+		parent.insert(std::make_pair(first, first));
+		parent.insert(std::make_pair(second, second));
+
+		std::string firstRoot = find(first);
+		std::string secondRoot = find(second);
+		if (firstRoot != secondRoot) {
+			parent[secondRoot] = firstRoot;
+		}
+	}
+
+	std::unordered_map<std::string, std::vector<std::string>> EquivalenceClasses::classes() {
+		std::unordered_map<std::string, std::vector<std::string>> result;
+		for (const auto &kv : parent) {
+			result[find(kv.first)].push_back(kv.first);
+		}
+
+		return result;
+	}
+
+	ColumnsBounds rewrite_const_filters(
+		const std::vector<ConstPredicate*> &constFilterPredicates,
+		const std::vector<AttributePredicate*> &joinPredicates
+	) {
+		ColumnsBounds result;
+
+		for (ConstPredicate *predicate : constFilterPredicates) {
+			if (!add_bound(result, predicate->attribute, predicate->relation, predicate->value)) {
+				result.isValid = false;
+				return result;
+			}
+		}
+
+		// every member of a class gets the conditions of all the members
+		for (const auto &kv : EquivalenceClasses(joinPredicates).classes()) {
+			std::vector<std::pair<Predicate::Relation, Value>> conditions;
+			for (const std::string &attribute : kv.second) {
+				auto exact = result.columnExactValue.find(attribute);
+				if (exact != result.columnExactValue.end()) {
+					conditions.emplace_back(Predicate::Relation::EQUAL, exact->second);
+				}
+
+				auto upper = result.columnUpperBound.find(attribute);
+				if (upper != result.columnUpperBound.end()) {
+					conditions.emplace_back(Predicate::Relation::LESS, upper->second);
 				}
 
-				default:
-					throw std::runtime_error("Unsupported predicate relation");
+				auto lower = result.columnLowerBound.find(attribute);
+				if (lower != result.columnLowerBound.end()) {
+					conditions.emplace_back(Predicate::Relation::GREATER, lower->second);
+				}
+			}
+
+			for (const auto &condition : conditions) {
+				// values of different types are never equal, so the join can't produce any rows
+				if (condition.second.type != conditions[0].second.type) {
+					result.isValid = false;
+					return result;
+				}
+			}
+
+			for (const std::string &attribute : kv.second) {
+				for (const auto &condition : conditions) {
+					if (!add_bound(result, attribute, condition.first, condition.second)) {
+						result.isValid = false;
+						return result;
+					}
+				}
 			}
 		}
 
@@ -22,7 +22,29 @@ namespace ToyDBMS {
 		std::vector<AttributePredicate*> predicates;
 	};
 
-	ColumnsBounds rewrite_const_filters(const std::vector<ConstPredicate*> &constFilterPredicates);
+	// Union-find over attribute names: attributes connected by equality
+	// predicates form one class and are equal in every row of the join.
+	class EquivalenceClasses {
+		std::unordered_map<std::string, std::string> parent;
+
+		public:
+			EquivalenceClasses(const std::vector<AttributePredicate*> &equalityPredicates);
+
+			std::string find(const std::string &attribute);
+
+			void unite(const std::string &first, const std::string &second);
+
+			// Members of every class, by the representative of the class.
+			std::unordered_map<std::string, std::vector<std::string>> classes();
+	};
+
+	// Folds the constant filters into bounds per column. Bounds spread across
+	// the equivalence classes of the join predicates, so every joined column
+	// gets the filters of the columns it is equal to.
+	ColumnsBounds rewrite_const_filters(
+		const std::vector<ConstPredicate*> &constFilterPredicates,
+		const std::vector<AttributePredicate*> &joinPredicates
+	);
 
 	class AttributeInequalitiesRewriter {
 		const std::vector<AttributePredicate*> inequalityPredicates;
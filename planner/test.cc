@@ -3,6 +3,8 @@
 #include <readline/history.h>
 
 #include "constructor.h"
+#include "../operators/arena.h"
+#include "../operators/explain.h"
 #include "../operators/print.h"
 
 using namespace ToyDBMS;
@@ -10,15 +12,27 @@ using namespace ToyDBMS;
 int main(){
 	std::cout.sync_with_stdio(false);
 
+	// every query allocates from the arena, which is reset after it
+	Arena arena;
+
     while(char *line = readline("> ")){
         if(*line == '\0') continue;
         try {
+            Arena::Scope scope(arena);
             const Query &q = Query::parse(line);
-            Print p(ConstructedQuery(q).takeOperator());
-            while(p.next());
+            std::unique_ptr<Operator> root = ConstructedQuery(q).takeOperator();
+            if(q.explain == Query::Explain::PLAN){
+                explain(*root, std::cout);
+            } else if(q.explain == Query::Explain::ANALYZE){
+                explain_analyze(std::move(root), std::cout);
+            } else {
+                Print p(std::move(root));
+                while(!p.nextBatch().empty());
+            }
         } catch(std::exception &e){
             std::cerr << e.what() << '\n';
         }
+        arena.reset();
         add_history(line);
         free(line);
     }
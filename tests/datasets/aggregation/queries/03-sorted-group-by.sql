@@ -0,0 +1 @@
+select A.g, min(A.v), min(A.s) from A groupby A.g;
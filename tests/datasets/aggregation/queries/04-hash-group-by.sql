@@ -0,0 +1 @@
+select B.k, min(B.name) from B groupby B.k;
@@ -0,0 +1 @@
+select count(*) from A, B where A.g = B.k groupby B.k;
@@ -0,0 +1 @@
+select min(A.s), min(B.name) from A, B where A.g = B.k;
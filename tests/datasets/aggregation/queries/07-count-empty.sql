@@ -0,0 +1 @@
+select count(*) from A where A.v > 100;
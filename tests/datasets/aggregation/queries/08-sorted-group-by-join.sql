@@ -0,0 +1 @@
+select A.g, min(B.name) from A, B where A.g = B.k groupby A.g;
@@ -0,0 +1 @@
+select A.name, B.shop from A, B where A.id = B.aid and A.price > 0;
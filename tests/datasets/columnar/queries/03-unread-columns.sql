@@ -0,0 +1 @@
+select A.name from A where A.price > 10;
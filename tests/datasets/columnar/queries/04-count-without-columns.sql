@@ -0,0 +1 @@
+select count(*) from A, B where A.id = B.aid;
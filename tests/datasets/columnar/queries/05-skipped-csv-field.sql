@@ -0,0 +1 @@
+select B.shop from B where B.aid > 2;
@@ -0,0 +1 @@
+explain select F.id, F.qty from F where F.qty > 40;
@@ -0,0 +1 @@
+explain select F.id, D.name, C.city from F, D, C where F.did = D.id and F.cust = C.code and D.region = 2;
@@ -0,0 +1 @@
+explain select distinct F.cust from F;
@@ -0,0 +1 @@
+explain select F.id from F where F.did in (select D.id from D where D.region = 3;);
@@ -0,0 +1 @@
+explain select count(*) from F, D, C where F.did = D.id;
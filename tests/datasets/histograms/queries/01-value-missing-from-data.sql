@@ -0,0 +1 @@
+select * from A where A.id = 50;
@@ -0,0 +1 @@
+select * from A where A.id > 5 and A.id < 103;
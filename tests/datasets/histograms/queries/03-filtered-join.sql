@@ -0,0 +1 @@
+select A.id, B.tag from A, B where A.id = B.aid and A.grp = 3 and A.id > 2;
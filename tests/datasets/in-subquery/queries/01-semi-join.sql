@@ -0,0 +1 @@
+select * from A where A.id in (select B.aid from B;);
@@ -0,0 +1 @@
+select * from A where A.id notin (select B.aid from B;);
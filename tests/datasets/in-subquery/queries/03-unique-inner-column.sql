@@ -0,0 +1 @@
+select A.id, A.grp from A where A.grp in (select C.grp from C;);
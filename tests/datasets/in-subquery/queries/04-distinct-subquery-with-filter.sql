@@ -0,0 +1 @@
+select A.name from A where A.id in (select distinct B.aid from B where B.flag = "y";) and A.grp > 1;
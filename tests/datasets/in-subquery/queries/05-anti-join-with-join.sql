@@ -0,0 +1 @@
+select A.id, D.x from A, D where A.id = D.aid and A.id notin (select B.aid from B;);
@@ -0,0 +1 @@
+select A.id, B.val from A, B where A.id = B.aid and A.id < 6;
@@ -0,0 +1 @@
+select A.name, B.val, C.tag from A, B, C where A.id = B.aid and B.aid = C.aid and C.aid > 8 and A.id < 19;
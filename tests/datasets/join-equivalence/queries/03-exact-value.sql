@@ -0,0 +1 @@
+select * from A, B where A.id = B.aid and B.aid = 9;
@@ -0,0 +1 @@
+select A.id from A, B where A.id = B.aid and A.id < 5 and B.aid > 10;
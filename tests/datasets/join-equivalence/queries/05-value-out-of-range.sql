@@ -0,0 +1 @@
+select A.id, C.tag from A, C where A.id = C.aid and A.id = 3;
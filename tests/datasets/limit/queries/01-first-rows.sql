@@ -0,0 +1 @@
+select A.x, A.n from A limit 3;
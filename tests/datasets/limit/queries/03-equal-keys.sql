@@ -0,0 +1 @@
+select A.x, A.n from A orderby A.n limit 3;
@@ -0,0 +1 @@
+select A.n, B.z from A, B where A.x = B.x orderby B.z limit 2;
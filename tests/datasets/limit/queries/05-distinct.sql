@@ -0,0 +1 @@
+select distinct A.n from A orderby A.n limit 2;
@@ -0,0 +1 @@
+select A.x from A limit 0;
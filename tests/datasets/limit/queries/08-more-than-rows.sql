@@ -0,0 +1 @@
+select A.y from A orderby A.y limit 100;
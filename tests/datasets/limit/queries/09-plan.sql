@@ -0,0 +1 @@
+explain select A.x, A.y from A orderby A.y limit 4;
@@ -0,0 +1 @@
+select * from A, B where A.k = B.k;
@@ -0,0 +1 @@
+select * from C, D where D.k = C.k;
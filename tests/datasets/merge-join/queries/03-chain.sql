@@ -0,0 +1 @@
+select A.a, B.b, C.c from A, B, C where A.k = B.k and B.k = C.k;
@@ -0,0 +1 @@
+select * from A orderby A.y;
@@ -0,0 +1 @@
+select A.n, A.x from A orderby A.n, A.y;
@@ -0,0 +1 @@
+explain select A.x, A.y, B.z from A, B where A.x = B.x orderby A.x;
@@ -0,0 +1 @@
+select A.x, B.z from A, B where A.x = B.x orderby A.x, B.z;
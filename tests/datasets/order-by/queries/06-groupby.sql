@@ -0,0 +1 @@
+select A.n, min(A.y) from A groupby A.n orderby A.n;
@@ -0,0 +1 @@
+select A.x, A.y from A where A.y > 2 orderby A.y;
@@ -0,0 +1 @@
+select distinct A.x from A;
@@ -0,0 +1 @@
+select F.id, D.name from F, D where F.did = D.id and D.region = 2;
@@ -0,0 +1 @@
+select F.id, F.qty, C.city from F, C where F.cust = C.code and C.city = "rome";
@@ -0,0 +1 @@
+select F.id, D.name, C.city from F, D, C where F.did = D.id and F.cust = C.code and D.region = 2 and C.city = "kyiv";
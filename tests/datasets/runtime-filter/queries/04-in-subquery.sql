@@ -0,0 +1 @@
+select F.id, F.did from F where F.did in (select D.id from D where D.region = 3;);
@@ -0,0 +1 @@
+select x.F.id, x.D.name from (select * from F, D where F.did = D.id;) as x where x.D.region = 2 and x.F.qty < 30;
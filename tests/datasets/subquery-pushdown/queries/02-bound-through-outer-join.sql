@@ -0,0 +1 @@
+select x.F.id, D.name from (select * from F where F.qty > 20;) as x, D where x.F.did = D.id and D.id < 4;
@@ -0,0 +1 @@
+select x.F.id from (select F.id, F.qty, F.did from F;) as x where x.F.qty > 40 and x.F.id < x.F.did;
@@ -0,0 +1 @@
+select y.x.F.id, y.x.F.qty from (select * from (select * from F;) as x where x.F.qty < 10;) as y where y.x.F.id > 5;
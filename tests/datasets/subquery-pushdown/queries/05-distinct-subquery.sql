@@ -0,0 +1 @@
+select x.F.id from (select distinct F.id, F.did from F;) as x where x.F.did = 3;
@@ -0,0 +1,226 @@
+// Runs benchmark queries and prints their timings as JSON.
+// Usage: benchexe [-r REPEATS] [-j THREADS] QUERY_FILE...
+// Has to be run in the directory of a dataset, like testexe. Every query is
+// planned and printed REPEATS times after one warm-up run, with its output
+// discarded. The queries run in processes of their own, so that the peak
+// resident memory of one does not hide the one of the next.
+
+#include <sys/resource.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "../parser/query.h"
+#include "../planner/constructor.h"
+#include "../operators/arena.h"
+#include "../operators/gather.h"
+#include "../operators/print.h"
+#include "../operators/threadpool.h"
+
+using namespace ToyDBMS;
+
+namespace {
+
+struct Measurement {
+    std::string error;
+    size_t rows = 0;
+    double input_rows = 0;
+    std::vector<double> milliseconds;
+    long peak_rss_kb = 0;
+};
+
+// Discards everything Print writes.
+class NullBuffer : public std::streambuf {
+protected:
+    std::streamsize xsputn(const char *, std::streamsize count) override { return count; }
+    int overflow(int c) override { return traits_type::not_eof(c); }
+};
+
+// Rows of the tables the plan scans, as the planner estimates them.
+double input_rows(Operator &op){
+    std::vector<std::unique_ptr<Operator> *> inputs = op.inputs();
+    if(inputs.empty()) return std::max(0.0, op.estimatedRows());
+    double result = 0;
+    for(std::unique_ptr<Operator> *input : inputs)
+        result += input_rows(**input);
+    return result;
+}
+
+// Plans and prints the query once, returns the number of rows printed.
+size_t run(const std::string &filename, size_t threads, double *scanned){
+    Arena arena;
+    Arena::Scope scope(arena);
+
+    Query query = Query::parse_file(filename);
+    std::unique_ptr<Operator> root = ConstructedQuery(query).takeOperator();
+    if(scanned) *scanned = input_rows(*root);
+    if(threads > 1)
+        root = std::make_unique<Gather>(std::move(root), true);
+
+    Print print(std::move(root));
+    size_t rows = 0;
+    for(Batch batch = print.nextBatch(); !batch.empty(); batch = print.nextBatch())
+        rows += batch.size();
+    return rows;
+}
+
+// Runs in the child process, the result goes to the parent as one line:
+// "ok ROWS INPUT_ROWS MILLISECONDS..." or "error MESSAGE".
+std::string measure(const std::string &filename, size_t threads, size_t repeats){
+    try {
+        ThreadPool::configure(threads);
+        NullBuffer null;
+        std::cout.rdbuf(&null);
+
+        std::ostringstream result;
+        result << std::setprecision(17) << "ok ";
+        double scanned = 0;
+        result << run(filename, threads, &scanned) << ' ' << scanned;
+
+        for(size_t i = 0; i < repeats; i++){
+            auto start = std::chrono::steady_clock::now();
+            run(filename, threads, nullptr);
+            std::chrono::duration<double, std::milli> elapsed = std::chrono::steady_clock::now() - start;
+            result << ' ' << elapsed.count();
+        }
+        return result.str();
+    } catch(std::exception &e){
+        std::string message = e.what();
+        std::replace(message.begin(), message.end(), '\n', ' ');
+        return "error " + message;
+    }
+}
+
+Measurement measure_in_child(const std::string &filename, size_t threads, size_t repeats){
+    int channel[2];
+    if(pipe(channel) != 0) throw std::runtime_error("pipe failed");
+    std::cout.flush();
+
+    pid_t child = fork();
+    if(child < 0) throw std::runtime_error("fork failed");
+    if(child == 0){
+        close(channel[0]);
+        std::string line = measure(filename, threads, repeats) + '\n';
+        for(size_t written = 0; written < line.size();){
+            ssize_t count = write(channel[1], line.data() + written, line.size() - written);
+            if(count <= 0) break;
+            written += count;
+        }
+        _exit(0);
+    }
+
+    close(channel[1]);
+    std::string line;
+    char buffer[4096];
+    for(ssize_t count; (count = read(channel[0], buffer, sizeof(buffer))) > 0;)
+        line.append(buffer, count);
+    close(channel[0]);
+
+    int status;
+    struct rusage usage;
+    if(wait4(child, &status, 0, &usage) < 0) throw std::runtime_error("wait failed");
+
+    Measurement result;
+    result.peak_rss_kb = usage.ru_maxrss;
+    std::istringstream parts(line);
+    std::string outcome;
+    parts >> outcome;
+    if(outcome == "ok"){
+        parts >> result.rows >> result.input_rows;
+        for(double ms; parts >> ms;) result.milliseconds.push_back(ms);
+    } else if(outcome == "error"){
+        std::getline(parts >> std::ws, result.error);
+    } else {
+        result.error = "the query process exited abnormally";
+    }
+    return result;
+}
+
+// The smallest run time that is not exceeded by the given part of the runs.
+double percentile(std::vector<double> sorted, double part){
+    std::sort(sorted.begin(), sorted.end());
+    size_t rank = std::ceil(part * sorted.size());
+    return sorted[std::max<size_t>(rank, 1) - 1];
+}
+
+std::string json_string(const std::string &s){
+    std::string result = "\"";
+    for(char c : s){
+        if(c == '"' || c == '\\'){
+            result += '\\';
+            result += c;
+        } else if(static_cast<unsigned char>(c) < 0x20){
+            char escaped[8];
+            std::snprintf(escaped, sizeof(escaped), "\\u%04x", c);
+            result += escaped;
+        } else result += c;
+    }
+    return result + "\"";
+}
+
+// The name of the query file without its directory and extension.
+std::string query_name(const std::string &filename){
+    std::string name = filename.substr(filename.rfind('/') + 1);
+    return name.substr(0, name.rfind('.'));
+}
+
+void print(const std::string &filename, const Measurement &m, std::ostream &os){
+    os << "    {\"query\": " << json_string(query_name(filename));
+    if(!m.error.empty()){
+        os << ", \"error\": " << json_string(m.error) << "}";
+        return;
+    }
+
+    double median = percentile(m.milliseconds, 0.5);
+    os << ", \"runs\": " << m.milliseconds.size()
+       << ", \"median_ms\": " << median
+       << ", \"p99_ms\": " << percentile(m.milliseconds, 0.99)
+       << ", \"min_ms\": " << percentile(m.milliseconds, 0)
+       << ", \"rows\": " << m.rows
+       << ", \"input_rows\": " << std::llround(m.input_rows)
+       << ", \"rows_per_second\": " << std::llround(median > 0 ? m.input_rows / median * 1000 : 0)
+       << ", \"peak_rss_kb\": " << m.peak_rss_kb << "}";
+}
+
+}
+
+int main(int argc, char **argv){
+    try {
+        size_t repeats = 10;
+        size_t threads = 1;
+        std::vector<std::string> queries;
+        for(int i = 1; i < argc; i++){
+            if(std::strcmp(argv[i], "-r") == 0 && i + 1 < argc){
+                repeats = std::max<size_t>(1, std::stoul(argv[++i]));
+            } else if(std::strcmp(argv[i], "-j") == 0 && i + 1 < argc){
+                threads = std::stoul(argv[++i]);
+            } else if(argv[i][0] != '-'){
+                queries.push_back(argv[i]);
+            } else throw std::runtime_error(std::string("unknown argument ") + argv[i]);
+        }
+
+        std::cout << std::fixed << std::setprecision(3)
+                  << "{\n  \"threads\": " << threads << ",\n  \"repeats\": " << repeats
+                  << ",\n  \"queries\": [\n";
+        for(size_t i = 0; i < queries.size(); i++){
+            print(queries[i], measure_in_child(queries[i], threads, repeats), std::cout);
+            std::cout << (i + 1 < queries.size() ? ",\n" : "\n");
+            std::cout.flush();
+        }
+        std::cout << "  ]\n}\n";
+        return 0;
+    } catch(std::exception &e){
+        std::cerr << e.what() << '\n';
+        return 1;
+    }
+}
@@ -0,0 +1,145 @@
+// Converts CSV tables into the columnar format read by ColumnarSource.
+// Usage: converterexe tables/A.csv [tables/B.csv ...]
+// Every tables/X.csv is written next to itself as tables/X.col.
+
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "../operators/datasource.h"
+#include "../operators/columnar.h"
+
+using namespace ToyDBMS;
+
+namespace {
+
+struct ColumnBuffer {
+    std::string name;
+    Value::Type type;
+    std::vector<int32_t> ints;
+    std::vector<uint64_t> offsets {0};
+    std::string blob;
+};
+
+uint64_t align(uint64_t offset){
+    return (offset + 7) & ~uint64_t(7);
+}
+
+void pad(std::ofstream &out, uint64_t &offset){
+    static const char zeros[8] = {};
+    uint64_t aligned = align(offset);
+    out.write(zeros, aligned - offset);
+    offset = aligned;
+}
+
+void convert(const std::string &csv_name){
+    std::size_t dot_pos = csv_name.rfind('.');
+    if(dot_pos == std::string::npos || csv_name.substr(dot_pos) != ".csv")
+        throw std::runtime_error("expected a .csv file: " + csv_name);
+    std::string col_name = csv_name.substr(0, dot_pos) + ".col";
+
+    DataSource source(csv_name);
+
+    std::vector<ColumnBuffer> columns;
+    for(const auto &field : source.fileHeader()){
+        ColumnBuffer column;
+        column.name = field.first.substr(field.first.find('.') + 1);
+        column.type = field.second;
+        columns.push_back(std::move(column));
+    }
+
+    uint64_t rows = 0;
+    for(Row row = source.next(); row; row = source.next(), rows++){
+        for(size_t i = 0; i < columns.size(); i++){
+            ColumnBuffer &column = columns[i];
+            switch(column.type){
+            case Value::Type::INT:
+                column.ints.push_back(row[i].intval());
+                break;
+            case Value::Type::STR:
+                column.blob.append(row[i].data(), row[i].size());
+                column.offsets.push_back(column.blob.size());
+                break;
+            }
+        }
+    }
+
+    ColumnarFileHeader file_header;
+    std::memcpy(file_header.magic, ColumnarFileHeader::MAGIC, sizeof(file_header.magic));
+    file_header.rows = rows;
+    file_header.columns = columns.size();
+
+    std::vector<ColumnarColumn> descriptors(columns.size());
+    uint64_t offset = sizeof(ColumnarFileHeader) + columns.size() * sizeof(ColumnarColumn);
+    for(size_t i = 0; i < columns.size(); i++){
+        descriptors[i].name_offset = offset;
+        descriptors[i].name_length = columns[i].name.size();
+        offset += columns[i].name.size();
+    }
+
+    for(size_t i = 0; i < columns.size(); i++){
+        ColumnarColumn &descriptor = descriptors[i];
+        offset = align(offset);
+        descriptor.data_offset = offset;
+        if(columns[i].type == Value::Type::INT){
+            descriptor.type = ColumnarColumn::INT;
+            descriptor.blob_offset = 0;
+            offset += columns[i].ints.size() * sizeof(int32_t);
+        } else {
+            descriptor.type = ColumnarColumn::STR;
+            offset += columns[i].offsets.size() * sizeof(uint64_t);
+            descriptor.blob_offset = offset;
+            offset += columns[i].blob.size();
+        }
+    }
+
+    std::ofstream out(col_name, std::ios::binary | std::ios::trunc);
+    if(!out.good())
+        throw std::runtime_error("failed to open file: " + col_name);
+
+    out.write(reinterpret_cast<const char *>(&file_header), sizeof(file_header));
+    out.write(reinterpret_cast<const char *>(descriptors.data()), descriptors.size() * sizeof(ColumnarColumn));
+    offset = sizeof(ColumnarFileHeader) + columns.size() * sizeof(ColumnarColumn);
+    for(const ColumnBuffer &column : columns){
+        out.write(column.name.data(), column.name.size());
+        offset += column.name.size();
+    }
+
+    for(const ColumnBuffer &column : columns){
+        pad(out, offset);
+        if(column.type == Value::Type::INT){
+            out.write(reinterpret_cast<const char *>(column.ints.data()), column.ints.size() * sizeof(int32_t));
+            offset += column.ints.size() * sizeof(int32_t);
+        } else {
+            out.write(reinterpret_cast<const char *>(column.offsets.data()), column.offsets.size() * sizeof(uint64_t));
+            out.write(column.blob.data(), column.blob.size());
+            offset += column.offsets.size() * sizeof(uint64_t) + column.blob.size();
+        }
+    }
+
+    if(!out.good())
+        throw std::runtime_error("failed to write file: " + col_name);
+
+    std::cout << csv_name << " -> " << col_name << " (" << rows << " rows)\n";
+}
+
+}
+
+int main(int argc, char **argv){
+    if(argc < 2){
+        std::cerr << "usage: " << argv[0] << " tables/A.csv [tables/B.csv ...]\n";
+        return 1;
+    }
+
+    try {
+        for(int i = 1; i < argc; i++)
+            convert(argv[i]);
+        return 0;
+    } catch(std::exception &e){
+        std::cerr << e.what() << '\n';
+        return 1;
+    }
+}
@@ -4,7 +4,9 @@
 # creates catalog.txt in the current working directory
 # creates $table.$column.hist files in the tables directory
 
-# every histogram will be equi-width with 10 buckets by default
+# every histogram will be equi-depth with 10 buckets by default:
+# buckets hold about the same number of rows and a value never spans two buckets,
+# each line is 'min max count distinct'
 
 import os
 import csv
@@ -21,17 +23,23 @@ def parse_value(header, row):
 def generate_histogram(filename, freq):
     N = 10 # number of buckets
     vals = sorted(freq.keys())
+    depth = sum(freq.values()) / float(N)
 
-    bucket_size = max(1, len(vals) / N)
-    leftover = len(vals) % N
+    buckets = []
+    current = []
+    seen = 0
+    for v in vals:
+        current.append(v)
+        seen += freq[v]
+        if seen >= depth * (len(buckets) + 1):
+            buckets.append(current)
+            current = []
+    if current:
+        buckets.append(current)
 
-    sizes = [bucket_size + (len(vals) >= N)] * leftover + [bucket_size] * (min(len(vals), N) - leftover)
-
-    i = iter(vals)
-    buckets = [[next(i) for _ in range(cur)] for cur in sizes]
     with open(filename, 'w') as f:
         for bucket in buckets:
-            f.write('%s %s %d\n' % (bucket[0], bucket[-1], sum(map(lambda v: freq[v], bucket))))
+            f.write('%s %s %d %d\n' % (bucket[0], bucket[-1], sum(freq[v] for v in bucket), len(bucket)))
 
 catalog = open('catalog.txt', 'w')
 
@@ -53,13 +61,13 @@ for filename in tables:
     table = filename.split('.')[0]
     with open('tables/' + filename, 'r') as f:
         reader = csv.reader(f)
-        header = reader.next()
+        header = next(reader)
         header = [{'name': name, 'type': types[t], 'order': 'UNKNOWN', 'counter': Counter(), 'min': 0, 'max': 0}
                   for t, name in (field.split('_') for field in header)]
         vals = [[] for i in range(len(header))]
         num_elements = 0
         try:
-            row = parse_value(header, reader.next())
+            row = parse_value(header, next(reader))
             num_elements += 1
             for i, v in enumerate(row):
                 header[i]['counter'][v] += 1
@@ -0,0 +1,293 @@
+// Generates the synthetic dataset the benchmark queries in bench/queries run on.
+// Usage: generatorexe [--scale F] [--skew Z] [--sortedness S] [--distinct U]
+//                     [--string-width W] [--seed N] [DIRECTORY]
+// Writes DIRECTORY/catalog.txt and DIRECTORY/tables/*.csv with a histogram
+// for every column, the same files util/generate_metadata.py writes.
+//
+// The tables, for scale 1:
+//   F  100000 rows: id, did -> D.id, gid, val in [0, 1000), name
+//   D   10000 rows: id, cid -> C.id, tag
+//   C     100 rows: id, label
+//   E  100000 rows: id, fid -> F.id
+// --skew       Zipf exponent of F.did, 0 makes it uniform
+// --sortedness part of F.id and E.fid left in ascending order, 1 keeps them sorted
+// --distinct   distinct values of F.gid, and of F.name made from it, per row of F;
+//              1 makes them unique
+// --string-width characters in F.name and D.tag
+
+#include <sys/stat.h>
+#include <algorithm>
+#include <cerrno>
+#include <cmath>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace {
+
+struct Options {
+    double scale = 1;
+    double skew = 0;
+    double sortedness = 1;
+    double distinct = 0.01;
+    size_t string_width = 12;
+    uint64_t seed = 1;
+    std::string directory = ".";
+};
+
+// A column is either of integers or of strings, the other vector stays empty.
+struct Column {
+    std::string name;
+    bool is_int;
+    std::vector<int> ints;
+    std::vector<std::string> strings;
+
+    Column(std::string name, bool is_int): name(std::move(name)), is_int(is_int) {}
+};
+
+struct Table {
+    std::string name;
+    size_t rows;
+    std::vector<Column> columns;
+};
+
+void make_directory(const std::string &path){
+    if(mkdir(path.c_str(), 0755) != 0 && errno != EEXIST)
+        throw std::runtime_error("could not create directory " + path + ": " + std::strerror(errno));
+}
+
+// Lowercase word made from the number, filled up to the width with letters
+// that depend on the number only, so equal numbers give equal strings.
+std::string word(uint64_t number, size_t width){
+    std::string result;
+    uint64_t rest = number;
+    do {
+        result += char('a' + rest % 26);
+        rest /= 26;
+    } while(rest > 0);
+
+    uint64_t filler = number * 0x9e3779b97f4a7c15ULL + 1;
+    while(result.size() < width){
+        filler ^= filler >> 29;
+        filler *= 0xbf58476d1ce4e5b9ULL;
+        result += char('a' + (filler >> 40) % 26);
+    }
+    result.resize(std::max<size_t>(width, 1));
+    return result;
+}
+
+// Sequence 1..n in ascending order where every position is left alone with
+// the given probability and swapped with a random one otherwise.
+std::vector<int> perturbed(std::vector<int> values, double sortedness, std::mt19937_64 &random){
+    std::bernoulli_distribution keep(sortedness);
+    std::uniform_int_distribution<size_t> position(0, values.size() - 1);
+    for(size_t i = 0; i < values.size(); i++){
+        if(!keep(random)) std::swap(values[i], values[position(random)]);
+    }
+    return values;
+}
+
+// Draws 1..n with probability proportional to 1 / rank^exponent, the ranks
+// are assigned to the values in a random order.
+class Zipf {
+    std::vector<double> cumulative;
+    std::vector<int> values;
+    std::uniform_real_distribution<double> uniform {0, 1};
+
+public:
+    Zipf(size_t n, double exponent, std::mt19937_64 &random){
+        double sum = 0;
+        for(size_t rank = 1; rank <= n; rank++){
+            sum += 1 / std::pow(double(rank), exponent);
+            cumulative.push_back(sum);
+        }
+        for(double &c : cumulative) c /= sum;
+
+        for(size_t i = 1; i <= n; i++) values.push_back(i);
+        std::shuffle(values.begin(), values.end(), random);
+    }
+
+    int operator()(std::mt19937_64 &random){
+        double u = uniform(random);
+        size_t rank = std::lower_bound(cumulative.begin(), cumulative.end(), u) - cumulative.begin();
+        return values[std::min(rank, values.size() - 1)];
+    }
+};
+
+std::vector<int> sequence(size_t n){
+    std::vector<int> result(n);
+    for(size_t i = 0; i < n; i++) result[i] = i + 1;
+    return result;
+}
+
+std::vector<Table> generate(const Options &options){
+    std::mt19937_64 random(options.seed);
+    auto rows = [&](double base){ return std::max<size_t>(1, std::llround(base * options.scale)); };
+
+    Table c {"C", rows(100), {}};
+    c.columns.emplace_back("id", true);
+    c.columns.emplace_back("label", false);
+    c.columns[0].ints = sequence(c.rows);
+    for(int id : c.columns[0].ints)
+        c.columns[1].strings.push_back("c" + std::to_string(id));
+
+    Table d {"D", rows(10000), {}};
+    d.columns.emplace_back("id", true);
+    d.columns.emplace_back("cid", true);
+    d.columns.emplace_back("tag", false);
+    d.columns[0].ints = sequence(d.rows);
+    std::uniform_int_distribution<int> category(1, c.rows);
+    for(int id : d.columns[0].ints){
+        d.columns[1].ints.push_back(category(random));
+        d.columns[2].strings.push_back(word(id, options.string_width));
+    }
+
+    Table f {"F", rows(100000), {}};
+    f.columns.emplace_back("id", true);
+    f.columns.emplace_back("did", true);
+    f.columns.emplace_back("gid", true);
+    f.columns.emplace_back("val", true);
+    f.columns.emplace_back("name", false);
+    f.columns[0].ints = perturbed(sequence(f.rows), options.sortedness, random);
+    Zipf dimension(d.rows, options.skew, random);
+    // every group occurs, so a fraction of 1 gives unique values
+    size_t groups = std::max<size_t>(1, std::llround(options.distinct * f.rows));
+    for(size_t i = 0; i < f.rows; i++) f.columns[2].ints.push_back(i % groups + 1);
+    std::shuffle(f.columns[2].ints.begin(), f.columns[2].ints.end(), random);
+    std::uniform_int_distribution<int> value(0, 999);
+    for(size_t i = 0; i < f.rows; i++){
+        f.columns[1].ints.push_back(dimension(random));
+        f.columns[3].ints.push_back(value(random));
+        f.columns[4].strings.push_back(word(f.columns[2].ints[i], options.string_width));
+    }
+
+    Table e {"E", rows(100000), {}};
+    e.columns.emplace_back("id", true);
+    e.columns.emplace_back("fid", true);
+    e.columns[0].ints = sequence(e.rows);
+    std::uniform_int_distribution<int> fact(1, f.rows);
+    std::vector<int> fids;
+    for(size_t i = 0; i < e.rows; i++) fids.push_back(fact(random));
+    std::sort(fids.begin(), fids.end());
+    e.columns[1].ints = perturbed(std::move(fids), options.sortedness, random);
+
+    return {std::move(c), std::move(d), std::move(f), std::move(e)};
+}
+
+// Writes the catalog entry of the column and its equi-depth histogram with
+// 10 buckets, computed the way util/generate_metadata.py does.
+template<typename T>
+void describe(const std::string &table, const std::string &column, const char *type,
+              const std::vector<T> &values, std::ostream &catalog, const std::string &directory){
+    std::string order = "UNKNOWN";
+    for(size_t i = 1; i < values.size(); i++){
+        if(order == "UNKNOWN"){
+            if(values[i] < values[i - 1]) order = "DESC";
+            if(values[i - 1] < values[i]) order = "ASC";
+        } else if(order == "DESC"){
+            if(values[i - 1] < values[i]) order = "UNSORTED";
+        } else if(order == "ASC"){
+            if(values[i] < values[i - 1]) order = "UNSORTED";
+        }
+    }
+
+    std::vector<T> sorted = values;
+    std::sort(sorted.begin(), sorted.end());
+    bool unique = std::adjacent_find(sorted.begin(), sorted.end()) == sorted.end();
+
+    catalog << "    " << column << ' ' << type << ' ' << order << ' ' << (unique ? "UNIQUE" : "NOTUNIQUE") << ' ';
+    if(sorted.empty()) catalog << "0 0\n";
+    else catalog << sorted.front() << ' ' << sorted.back() << '\n';
+
+    const size_t BUCKETS = 10;
+    double depth = sorted.size() / double(BUCKETS);
+    std::ofstream histogram(directory + "/tables/" + table + "." + column + ".hist");
+    size_t buckets = 0, seen = 0, bucket_begin = 0, bucket_count = 0, bucket_distinct = 0;
+    for(size_t i = 0; i < sorted.size();){
+        size_t j = i;
+        while(j < sorted.size() && !(sorted[i] < sorted[j])) j++;
+        if(bucket_count == 0) bucket_begin = i;
+        bucket_count += j - i;
+        bucket_distinct++;
+        seen += j - i;
+        if(seen >= depth * (buckets + 1) || j == sorted.size()){
+            histogram << sorted[bucket_begin] << ' ' << sorted[i] << ' ' << bucket_count << ' ' << bucket_distinct << '\n';
+            buckets++;
+            bucket_count = bucket_distinct = 0;
+        }
+        i = j;
+    }
+}
+
+void write(const Table &table, std::ostream &catalog, const std::string &directory){
+    std::ofstream csv(directory + "/tables/" + table.name + ".csv");
+    for(size_t i = 0; i < table.columns.size(); i++){
+        if(i > 0) csv << ',';
+        csv << (table.columns[i].is_int ? "i_" : "s_") << table.columns[i].name;
+    }
+    csv << '\n';
+    for(size_t row = 0; row < table.rows; row++){
+        for(size_t i = 0; i < table.columns.size(); i++){
+            if(i > 0) csv << ',';
+            const Column &column = table.columns[i];
+            if(column.is_int) csv << column.ints[row];
+            else csv << column.strings[row];
+        }
+        csv << '\n';
+    }
+    if(!csv) throw std::runtime_error("could not write table " + table.name);
+
+    catalog << table.name << ' ' << table.rows << '\n';
+    for(const Column &column : table.columns){
+        if(column.is_int) describe(table.name, column.name, "INT", column.ints, catalog, directory);
+        else describe(table.name, column.name, "STR", column.strings, catalog, directory);
+    }
+}
+
+double fraction(const char *argument, const char *option){
+    double value = std::stod(argument);
+    if(value < 0 || value > 1)
+        throw std::runtime_error(std::string(option) + " has to be between 0 and 1");
+    return value;
+}
+
+}
+
+int main(int argc, char **argv){
+    try {
+        Options options;
+        for(int i = 1; i < argc; i++){
+            std::string argument = argv[i];
+            bool has_value = i + 1 < argc;
+            if(argument == "--scale" && has_value){
+                options.scale = std::stod(argv[++i]);
+            } else if(argument == "--skew" && has_value){
+                options.skew = std::stod(argv[++i]);
+            } else if(argument == "--sortedness" && has_value){
+                options.sortedness = fraction(argv[++i], "--sortedness");
+            } else if(argument == "--distinct" && has_value){
+                options.distinct = fraction(argv[++i], "--distinct");
+            } else if(argument == "--string-width" && has_value){
+                options.string_width = std::stoul(argv[++i]);
+            } else if(argument == "--seed" && has_value){
+                options.seed = std::stoull(argv[++i]);
+            } else if(argument.compare(0, 2, "--") != 0){
+                options.directory = argument;
+            } else throw std::runtime_error("unknown argument " + argument);
+        }
+
+        make_directory(options.directory);
+        make_directory(options.directory + "/tables");
+        std::ofstream catalog(options.directory + "/catalog.txt");
+        for(const Table &table : generate(options))
+            write(table, catalog, options.directory);
+        return 0;
+    } catch(std::exception &e){
+        std::cerr << e.what() << '\n';
+        return 1;
+    }
+}
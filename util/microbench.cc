@@ -0,0 +1,333 @@
+// Measures the cost per tuple of single operators fed from rows in memory.
+// Usage: microbenchexe [--rows N] [OPERATOR...]
+// Runs every benchmark whose operator name is given, or all of them. Every
+// benchmark sweeps the row width, the number of distinct keys and the length
+// of the strings (0 stands for integer columns) and reports, for reading the
+// operator by next() and by nextBatch(), the nanoseconds and heap allocations
+// per tuple the operator reads or produces, whichever are more.
+
+#include <sys/stat.h>
+#include <unistd.h>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <new>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "../parser/query.h"
+#include "../operators/arena.h"
+#include "../operators/cache.h"
+#include "../operators/datasource.h"
+#include "../operators/filter.h"
+#include "../operators/join.h"
+#include "../operators/OptimizedUnique.h"
+#include "../operators/projection.h"
+#include "../operators/sort.h"
+#include "../operators/unique.h"
+
+namespace {
+std::atomic<size_t> allocations {0};
+}
+
+// every allocation of the process goes through these
+void *operator new(size_t size){
+    allocations.fetch_add(1, std::memory_order_relaxed);
+    if(void *memory = std::malloc(size ? size : 1)) return memory;
+    throw std::bad_alloc();
+}
+
+void operator delete(void *memory) noexcept { std::free(memory); }
+void operator delete(void *memory, size_t) noexcept { operator delete(memory); }
+
+using namespace ToyDBMS;
+
+namespace {
+
+struct Params {
+    size_t width;
+    size_t keys;
+    size_t string_length;
+};
+
+// Rows of `width` columns named TABLE.c0, TABLE.c1, ... whose values all
+// follow from the key in c0, so there are as many distinct rows as keys.
+struct Input {
+    Header header;
+    std::vector<Row> rows;
+
+    Input(const std::string &table, const Params &params, size_t count, bool sorted){
+        for(size_t i = 0; i < params.width; i++)
+            header.push_back(table + ".c" + std::to_string(i));
+        for(size_t i = 0; i < count; i++){
+            size_t key = sorted ? i * params.keys / count : (i * 0x9e3779b97f4a7c15ULL >> 17) % params.keys;
+            std::vector<Value> values;
+            for(size_t column = 0; column < params.width; column++)
+                values.push_back(value(key * (column + 1), params.string_length));
+            rows.emplace_back(std::move(values));
+        }
+    }
+
+    static Value value(size_t number, size_t string_length){
+        if(string_length == 0) return Value(int(number));
+        std::string s(string_length, 'a');
+        for(size_t i = 0; i < string_length && number > 0; i++, number /= 26)
+            s[string_length - 1 - i] = char('a' + number % 26);
+        return Value(s);
+    }
+};
+
+// Hands out copies of the rows of an input and counts them.
+class MockSource : public Operator {
+    const Input &input;
+    size_t &served;
+    size_t position = 0;
+public:
+    MockSource(const Input &input, size_t &served): input(input), served(served) {}
+
+    const Header &header() override { return input.header; }
+
+    Row next() override {
+        if(position == input.rows.size()) return {};
+        served++;
+        return input.rows[position++];
+    }
+
+    Batch nextBatch() override {
+        Batch batch(input.header.size());
+        while(!batch.full() && position < input.rows.size())
+            batch.append(std::vector<Value>(input.rows[position++].values));
+        served += batch.size();
+        return batch;
+    }
+
+    void reset() override { position = 0; }
+    std::string describe() override { return "MockSource"; }
+};
+
+struct Result {
+    double nanoseconds;
+    double allocations;
+};
+
+size_t drain(Operator &op, bool batches){
+    size_t rows = 0;
+    if(batches){
+        for(Batch batch = op.nextBatch(); !batch.empty(); batch = op.nextBatch())
+            rows += batch.size();
+    } else {
+        while(op.next()) rows++;
+    }
+    return rows;
+}
+
+// Reads the operator once to warm it up, then resets and reads it again
+// until enough time has passed.
+Result measure(Operator &op, const size_t &served, bool batches){
+    using Clock = std::chrono::steady_clock;
+    drain(op, batches);
+
+    size_t tuples = 0;
+    size_t passes = 0;
+    size_t allocated = allocations;
+    Clock::time_point start = Clock::now();
+    Clock::duration elapsed;
+    do {
+        op.reset();
+        size_t before = served;
+        size_t produced = drain(op, batches);
+        tuples += std::max(produced, served - before);
+        passes++;
+        elapsed = Clock::now() - start;
+    } while(passes < 3 || elapsed < std::chrono::milliseconds(200));
+    allocated = allocations - allocated;
+
+    tuples = std::max<size_t>(tuples, 1);
+    return {
+        double(std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count()) / tuples,
+        double(allocated) / tuples
+    };
+}
+
+// Builds the operator under test, fed by mock sources that count into `served`.
+using Builder = std::function<std::unique_ptr<Operator>(const Params &, size_t rows, size_t &served)>;
+
+struct Benchmark {
+    std::string name;
+    std::vector<Params> sweep;
+    Builder build;
+};
+
+std::vector<Params> sweep(std::vector<size_t> widths, std::vector<size_t> keys, std::vector<size_t> lengths){
+    std::vector<Params> result;
+    for(size_t width : widths)
+        for(size_t key : keys)
+            for(size_t length : lengths)
+                result.push_back({width, key, length});
+    return result;
+}
+
+// Inputs live as long as the benchmarks, which keep references to them.
+std::vector<std::unique_ptr<Input>> inputs;
+
+const Input &input(const std::string &table, const Params &params, size_t rows, bool sorted = false){
+    inputs.push_back(std::make_unique<Input>(table, params, rows, sorted));
+    return *inputs.back();
+}
+
+std::unique_ptr<Operator> mock(const std::string &table, const Params &params, size_t rows, size_t &served, bool sorted = false){
+    return std::make_unique<MockSource>(input(table, params, rows, sorted), served);
+}
+
+// Writes the rows as a CSV table into the directory and returns its file name.
+std::string write_table(const std::string &directory, const Params &params, size_t rows){
+    const Input &data = input("T", params, rows);
+    std::string filename = directory + "/T.csv";
+    std::ofstream csv(filename);
+    for(size_t i = 0; i < params.width; i++)
+        csv << (i ? "," : "") << (params.string_length ? "s_c" : "i_c") << i;
+    csv << '\n';
+    for(const Row &row : data.rows){
+        for(size_t i = 0; i < row.size(); i++)
+            csv << (i ? "," : "") << row[i];
+        csv << '\n';
+    }
+    return filename;
+}
+
+// The median of the first column, a filter on it keeps half of the rows.
+Value median_key(const Params &params, size_t rows){
+    const Input &data = input("T", params, rows);
+    std::vector<Value> keys;
+    for(const Row &row : data.rows) keys.push_back(row[0]);
+    std::nth_element(keys.begin(), keys.begin() + keys.size() / 2, keys.end());
+    return keys[keys.size() / 2];
+}
+
+std::vector<Benchmark> benchmarks(const char *directory){
+    std::vector<size_t> widths {1, 4, 16};
+    std::vector<size_t> lengths {0, 8, 32};
+    // the joins compare every pair, so they read fewer rows
+    auto join_rows = [](size_t rows){ return std::max<size_t>(1, rows / 100); };
+
+    return {
+        {"MockSource", sweep(widths, {1000}, lengths),
+            [](const Params &p, size_t rows, size_t &served){ return mock("T", p, rows, served); }},
+
+        {"DataSource", sweep(widths, {1000}, lengths),
+            [directory](const Params &p, size_t rows, size_t &){
+                return std::unique_ptr<Operator>(new DataSource(write_table(directory, p, rows)));
+            }},
+
+        {"Filter", sweep(widths, {1000}, lengths),
+            [](const Params &p, size_t rows, size_t &served){
+                std::unique_ptr<Predicate> predicate(new ConstPredicate("T.c0", median_key(p, rows), Predicate::Relation::LESS));
+                return std::unique_ptr<Operator>(new Filter(mock("T", p, rows, served), std::move(predicate)));
+            }},
+
+        {"Projection", sweep(widths, {1000}, lengths),
+            [](const Params &p, size_t rows, size_t &served){
+                std::unique_ptr<Operator> source = mock("T", p, rows, served);
+                Header kept;
+                for(size_t i = 0; i < p.width; i += 2) kept.push_back(source->header()[i]);
+                return std::unique_ptr<Operator>(new Projection(std::move(source), std::move(kept)));
+            }},
+
+        {"NLJoin", sweep({1, 4}, {16, 1000}, {0, 32}),
+            [join_rows](const Params &p, size_t rows, size_t &served){
+                return std::unique_ptr<Operator>(new NLJoin(
+                    mock("L", p, join_rows(rows), served), mock("R", p, join_rows(rows), served), "L.c0", "R.c0"));
+            }},
+
+        {"CrossJoin", sweep({1, 4}, {1000}, {0, 32}),
+            [join_rows](const Params &p, size_t rows, size_t &served){
+                return std::unique_ptr<Operator>(new CrossJoin(
+                    mock("L", p, join_rows(rows), served), mock("R", p, join_rows(rows), served)));
+            }},
+
+        {"Unique", sweep({1, 4}, {16, 1024, 65536}, {0, 8, 32}),
+            [](const Params &p, size_t rows, size_t &served){
+                return std::unique_ptr<Operator>(new Unique(mock("T", p, rows, served, true)));
+            }},
+
+        // the same input as Unique, which is sorted on the key
+        {"OptimizedUnique", sweep({1, 4}, {16, 1024, 65536}, {0, 8, 32}),
+            [](const Params &p, size_t rows, size_t &served){
+                return std::unique_ptr<Operator>(new OptimizedUnique(mock("T", p, rows, served, true), {"T.c0"}));
+            }},
+
+        // the first read sorts the input in memory, the measured ones merge the runs again
+        {"Sort", sweep({1, 4}, {16, 1024, 65536}, {0, 8, 32}),
+            [](const Params &p, size_t rows, size_t &served){
+                return std::unique_ptr<Operator>(new Sort(mock("T", p, rows, served), {"T.c0"}));
+            }},
+
+        // the first read fills the cache, the measured ones replay it
+        {"Cache", sweep(widths, {1000}, lengths),
+            [](const Params &p, size_t rows, size_t &served){
+                return std::unique_ptr<Operator>(new Cache(mock("T", p, rows, served)));
+            }},
+    };
+}
+
+// Removes the directory the DataSource benchmark writes its table to.
+void remove_directory(const char *directory){
+    std::remove((std::string(directory) + "/T.csv").c_str());
+    rmdir(directory);
+}
+
+}
+
+int main(int argc, char **argv){
+    char directory[] = "/tmp/microbench.XXXXXX";
+    try {
+        size_t rows = 100000;
+        std::vector<std::string> selected;
+        for(int i = 1; i < argc; i++){
+            if(std::strcmp(argv[i], "--rows") == 0 && i + 1 < argc){
+                rows = std::max<size_t>(1, std::stoul(argv[++i]));
+            } else if(argv[i][0] != '-'){
+                selected.push_back(argv[i]);
+            } else throw std::runtime_error(std::string("unknown argument ") + argv[i]);
+        }
+
+        if(!mkdtemp(directory)) throw std::runtime_error("could not create a temporary directory");
+
+        // declared before the operators, so everything they allocate from it outlives them
+        Arena arena;
+        Arena::Scope scope(arena);
+
+        std::cout << std::fixed << std::setprecision(2)
+                  << "operator\twidth\tkeys\tstring\tmode\tns/tuple\tallocs/tuple\n";
+        for(Benchmark &benchmark : benchmarks(directory)){
+            if(!selected.empty() && std::find(selected.begin(), selected.end(), benchmark.name) == selected.end())
+                continue;
+            for(const Params &params : benchmark.sweep){
+                for(bool batches : {false, true}){
+                    size_t served = 0;
+                    std::unique_ptr<Operator> op = benchmark.build(params, rows, served);
+                    Result result = measure(*op, served, batches);
+                    std::cout << benchmark.name << '\t' << params.width << '\t' << params.keys << '\t'
+                              << params.string_length << '\t' << (batches ? "batch" : "row") << '\t'
+                              << result.nanoseconds << '\t' << result.allocations << std::endl;
+                    op = nullptr; // before the inputs it reads
+                    inputs.clear();
+                }
+            }
+        }
+        remove_directory(directory);
+        return 0;
+    } catch(std::exception &e){
+        std::cerr << e.what() << '\n';
+        remove_directory(directory);
+        return 1;
+    }
+}